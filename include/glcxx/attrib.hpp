@@ -22,6 +22,9 @@
 
 #include "glcxx/shader_type.hpp"
 #include "glcxx/buffer.hpp"
+#include "glcxx/packed_types.hpp"
+#include "glcxx/capabilities.hpp"
+#include <glm/gtc/type_ptr.hpp>
 
 namespace glcxx
 {
@@ -32,22 +35,26 @@ namespace glcxx
     template<typename ShaderType, typename Name>
     using attrib_declaration = ct::string_cat<cts("in "), typename shader_type::traits<ShaderType>::name, cts(" "), Name, cts(";\n")>;
 
-    /// @brief glVertexAttribPointer for float based shader type
+    /// @brief glVertexAttribPointer for float based shader type, components_num
+    /// is number of components of host type, which may differ from shader's,
+    /// e.g. for packed types
     template<typename ShaderType>
     static inline auto gl_vertex_attrib_pointer(const GLint location,
+                                                const GLint components_num,
                                                 const GLenum type,
                                                 const bool normalize,
                                                 const GLsizei stride,
                                                 const GLsizei byte_offset)
         -> std::enable_if_t<shader_type::traits<ShaderType>::id == GL_FLOAT>
     {
-        glVertexAttribPointer(location, shader_type::traits<ShaderType>::components_num, type,
+        glVertexAttribPointer(location, components_num, type,
                               normalize, stride, reinterpret_cast<const void*>(byte_offset));
     }
 
     /// @brief glVertexAttribPointer for integer shader types
     template<typename ShaderType>
     static inline auto gl_vertex_attrib_pointer(const GLint location,
+                                                const GLint components_num,
                                                 const GLenum type,
                                                 const bool /*normalize*/, // ignored
                                                 const GLsizei stride,
@@ -59,7 +66,7 @@ namespace glcxx
                             shader_type::traits<ShaderType>::id == GL_INT ||
                             shader_type::traits<ShaderType>::id == GL_UNSIGNED_INT>
     {
-        glVertexAttribIPointer(location, shader_type::traits<ShaderType>::components_num,
+        glVertexAttribIPointer(location, components_num,
                                type, stride, reinterpret_cast<const void*>(byte_offset));
     }
 
@@ -67,138 +74,441 @@ namespace glcxx
     /// @brief glVertexAttribPointer for double shader type
     template<typename ShaderType>
     static inline auto gl_vertex_attrib_pointer(const GLint location,
+                                                const GLint components_num,
                                                 const GLenum type,
                                                 const bool /*normalize*/, // ignored
                                                 const GLsizei stride,
                                                 const GLsizei byte_offset)
         -> std::enable_if_t<shader_type::traits<ShaderType>::id == GL_DOUBLE>
     {
-        glVertexAttribLPointer(location, shader_type::traits<ShaderType>::components_num,
+        glVertexAttribLPointer(location, components_num,
                                type, stride, reinterpret_cast<const void*>(byte_offset));
     }
 #endif
 
+    /// @brief functions to set current value of attribute with disabled
+    /// array, overloaded by shader type, use macro to reduce repetition
+#define DECLARE_GL_VERTEX_ATTRIB_FUNCTIONS(type, prefix, suffix)         \
+    inline void gl_vertex_attrib(GLint location, type val) {            \
+        glVertexAttrib##prefix##1##suffix(location, val);               \
+    }                                                                   \
+    inline void                                                         \
+    gl_vertex_attrib(GLint location, const glm::tvec1<type>& val) {     \
+        glVertexAttrib##prefix##1##suffix##v(location, glm::value_ptr(val)); \
+    }                                                                   \
+    inline void                                                         \
+    gl_vertex_attrib(GLint location, const glm::tvec2<type>& val) {     \
+        glVertexAttrib##prefix##2##suffix##v(location, glm::value_ptr(val)); \
+    }                                                                   \
+    inline void                                                         \
+    gl_vertex_attrib(GLint location, const glm::tvec3<type>& val) {     \
+        glVertexAttrib##prefix##3##suffix##v(location, glm::value_ptr(val)); \
+    }                                                                   \
+    inline void                                                         \
+    gl_vertex_attrib(GLint location, const glm::tvec4<type>& val) {     \
+        glVertexAttrib##prefix##4##suffix##v(location, glm::value_ptr(val)); \
+    }
+
+    /// @brief actual function definitions
+    DECLARE_GL_VERTEX_ATTRIB_FUNCTIONS(float, , f);
+    DECLARE_GL_VERTEX_ATTRIB_FUNCTIONS(int, I, i);
+    DECLARE_GL_VERTEX_ATTRIB_FUNCTIONS(unsigned int, I, ui);
+#ifdef glVertexAttribL1d
+    DECLARE_GL_VERTEX_ATTRIB_FUNCTIONS(double, L, d);
+#endif
+
+    /// @brief overloads for matrices, each column occupies own location
+    template<typename T>
+    inline void gl_vertex_attrib(GLint location, const glm::tmat2x2<T>& val) {
+        for (GLint i = 0; i < 2; ++i)
+            gl_vertex_attrib(location + i, val[i]);
+    }
+    template<typename T>
+    inline void gl_vertex_attrib(GLint location, const glm::tmat3x3<T>& val) {
+        for (GLint i = 0; i < 3; ++i)
+            gl_vertex_attrib(location + i, val[i]);
+    }
+    template<typename T>
+    inline void gl_vertex_attrib(GLint location, const glm::tmat4x4<T>& val) {
+        for (GLint i = 0; i < 4; ++i)
+            gl_vertex_attrib(location + i, val[i]);
+    }
+
+#ifdef GLCXX_USE_VERTEX_ATTRIB_BINDING
+    /// @brief glVertexAttribFormat for float based shader type, relative
+    /// offset is always 0 as offset is part of vertex buffer binding
+    template<typename ShaderType>
+    static inline auto gl_vertex_attrib_format(const GLuint vao,
+                                               const GLint location,
+                                               const GLint components_num,
+                                               const GLenum type,
+                                               const bool normalize)
+        -> std::enable_if_t<shader_type::traits<ShaderType>::id == GL_FLOAT>
+    {
+#ifdef GLCXX_USE_DSA
+        if (has_dsa())
+            return glVertexArrayAttribFormat(vao, location, components_num, type, normalize, 0);
+#endif
+        (void)vao;
+        glVertexAttribFormat(location, components_num, type, normalize, 0);
+    }
+
+    /// @brief glVertexAttribFormat for integer shader types
+    template<typename ShaderType>
+    static inline auto gl_vertex_attrib_format(const GLuint vao,
+                                               const GLint location,
+                                               const GLint components_num,
+                                               const GLenum type,
+                                               const bool /*normalize*/) // ignored
+        -> std::enable_if_t<shader_type::traits<ShaderType>::id == GL_BYTE ||
+                            shader_type::traits<ShaderType>::id == GL_UNSIGNED_BYTE ||
+                            shader_type::traits<ShaderType>::id == GL_SHORT ||
+                            shader_type::traits<ShaderType>::id == GL_UNSIGNED_SHORT ||
+                            shader_type::traits<ShaderType>::id == GL_INT ||
+                            shader_type::traits<ShaderType>::id == GL_UNSIGNED_INT>
+    {
+#ifdef GLCXX_USE_DSA
+        if (has_dsa())
+            return glVertexArrayAttribIFormat(vao, location, components_num, type, 0);
+#endif
+        (void)vao;
+        glVertexAttribIFormat(location, components_num, type, 0);
+    }
+
+#ifdef glVertexAttribLFormat
+    /// @brief glVertexAttribFormat for double shader type
+    template<typename ShaderType>
+    static inline auto gl_vertex_attrib_format(const GLuint vao,
+                                               const GLint location,
+                                               const GLint components_num,
+                                               const GLenum type,
+                                               const bool /*normalize*/) // ignored
+        -> std::enable_if_t<shader_type::traits<ShaderType>::id == GL_DOUBLE>
+    {
+#ifdef GLCXX_USE_DSA
+        if (has_dsa())
+            return glVertexArrayAttribLFormat(vao, location, components_num, type, 0);
+#endif
+        (void)vao;
+        glVertexAttribLFormat(location, components_num, type, 0);
+    }
+#endif
+
+    /// @brief enables attribute and connects it to binding point with same
+    /// index as location
+    inline void gl_enable_vertex_attrib(const GLuint vao, const GLint location)
+    {
+#ifdef GLCXX_USE_DSA
+        if (has_dsa())
+        {
+            glEnableVertexArrayAttrib(vao, location);
+            glVertexArrayAttribBinding(vao, location, location);
+            return;
+        }
+#endif
+        (void)vao;
+        glEnableVertexAttribArray(location);
+        glVertexAttribBinding(location, location);
+    }
+
+    /// @brief disables attribute
+    inline void gl_disable_vertex_attrib(const GLuint vao, const GLint location)
+    {
+#ifdef GLCXX_USE_DSA
+        if (has_dsa())
+            return glDisableVertexArrayAttrib(vao, location);
+#endif
+        (void)vao;
+        glDisableVertexAttribArray(location);
+    }
+
+    /// @brief binds buffer to vertex buffer binding point
+    inline void gl_bind_vertex_buffer(const GLuint vao,
+                                      const GLuint binding,
+                                      const GLuint buffer,
+                                      const GLintptr byte_offset,
+                                      const GLsizei stride,
+                                      const GLuint divisor)
+    {
+#ifdef GLCXX_USE_DSA
+        if (has_dsa())
+        {
+            glVertexArrayVertexBuffer(vao, binding, buffer, byte_offset, stride);
+            glVertexArrayBindingDivisor(vao, binding, divisor);
+            return;
+        }
+#endif
+        (void)vao;
+        glBindVertexBuffer(binding, buffer, byte_offset, stride);
+        glVertexBindingDivisor(binding, divisor);
+    }
+#endif
+
     /// @brief holds buffer and its layout
     class attrib
     {
         buffer_base_ptr _buffer;
         GLenum _type;
+        GLint _components_num;
         GLuint _divisor = 0;
         GLsizei _stride;
         bool _normalize = true;
         GLsizei _basic_type_size;
         GLsizei _byte_offset = 0;
 
+        /// @brief true if buffer was created by upload for this attribute,
+        /// only such buffer may be reallocated by next upload, buffers set
+        /// from outside, e.g. arena or stream buffer ranges, may hold other
+        /// data, even if attribute is their only owner
+        bool _owned = false;
+
+        /// @brief first location attribute was attached to, -1 if it wasn't
+        /// attached, and number of locations, e.g. 4 for mat4
+        mutable GLint _location = -1;
+        mutable GLint _locations_num = 0;
+
+        /// @brief byte size of single location of attached shader type
+        mutable GLsizei _location_size = 0;
+
     public:
-        /// @return true if was changed
-        template<typename T> inline bool
-        set(buffer_ptr<T> buf,
+        /// @brief kind of change made by set or upload, binding change is
+        /// buffer, offset, stride or divisor change, which may be applied
+        /// without format respecification
+        enum change { unchanged = 0, binding_changed, format_changed };
+
+        /// @brief set buffer and layout of attribute of type T, owned should
+        /// be true only for buffer dedicated to this attribute
+        /// @return what was changed
+        template<typename T> inline change
+        reset(buffer_base_ptr buf,
+              const GLsizei stride,
+              const GLsizei byte_offset,
               const GLuint divisor,
-              const GLsizei offset,
-              const bool normalize)
+              const bool normalize,
+              const bool owned = false)
         {
-            const GLsizei byte_offset = offset*sizeof(T);
-            if (_buffer != buf ||
+            _owned = owned;
+            using traits = shader_type::traits<T>;
+            const bool format = !_buffer || !buf ||
+                _type != traits::id ||
+                _components_num != traits::components_num ||
+                _normalize != normalize ||
+                _basic_type_size != sizeof(typename traits::basic_type);
+            if (format ||
+                _buffer != buf ||
                 _divisor != divisor ||
-                _byte_offset != byte_offset ||
-                _normalize != normalize)
+                _stride != stride ||
+                _byte_offset != byte_offset)
             {
                 _buffer = std::move(buf);
-                _type = shader_type::traits<T>::id;
+                _type = traits::id;
+                _components_num = traits::components_num;
                 _divisor = divisor;
-                _stride = sizeof(T);
+                _stride = stride;
                 _normalize = normalize;
-                _basic_type_size = sizeof(typename shader_type::traits<T>::basic_type);
+                _basic_type_size = sizeof(typename traits::basic_type);
                 _byte_offset = byte_offset;
-                return true;
+                return format ? format_changed : binding_changed;
             }
-            return false;
+            return unchanged;
+        }
+
+        /// @return what was changed
+        template<typename T> inline change
+        set(buffer_ptr<T> buf,
+              const GLuint divisor,
+              const GLsizei offset,
+              const bool normalize)
+        {
+            return reset<T>(std::move(buf), sizeof(T), offset*sizeof(T), divisor, normalize);
         }
 
-        /// @return true if was changed
-        template<typename T, typename U> inline bool
+        /// @return what was changed
+        template<typename T, typename U> inline change
         set(buffer_ptr<T> buf,
             U T::*member,
             const GLuint divisor,
             const GLsizei offset,
             const bool normalize)
         {
-            const GLsizei byte_offset = member_offset(member) + offset*sizeof(T);
-            if (_buffer != buf ||
-                _divisor != divisor ||
-                _byte_offset != byte_offset ||
-                _normalize != normalize)
-            {
-                _buffer = std::move(buf);
-                _type = shader_type::traits<U>::id;
-                _divisor = divisor;
-                _stride = sizeof(T);
-                _normalize = normalize;
-                _basic_type_size = sizeof(typename shader_type::traits<U>::basic_type);
-                _byte_offset = byte_offset;
-                return true;
-            }
-            return false;
+            return reset<U>(std::move(buf), sizeof(T), member_offset(member) + offset*sizeof(T), divisor, normalize);
         }
 
-        /// @return true if attribute should be reattached after upload
+        /// @return what was changed
+        template<typename T> inline change
+        set(buffer_range<T> range,
+            const GLuint divisor,
+            const bool normalize)
+        {
+            return reset<T>(std::move(range.buffer), sizeof(T), range.byte_offset, divisor, normalize);
+        }
+
+        /// @return what was changed
+        template<typename T, typename U> inline change
+        set(buffer_range<T> range,
+            U T::*member,
+            const GLuint divisor,
+            const bool normalize)
+        {
+            return reset<U>(std::move(range.buffer), sizeof(T), range.byte_offset + member_offset(member), divisor, normalize);
+        }
+
+        /// @return what was changed
         template<typename T>
-        bool upload(const T* data, size_t size, GLenum usage = 0)
+        change upload(const T* data, size_t size, GLenum usage = 0)
         {
-            // buffer exists and no one else is using it
-            if (_buffer && 1 == _buffer.use_count())
+            // buffer was created by previous upload and no one else is using it
+            if (owns_buffer(1))
             {
                 _buffer->upload(data, size*sizeof(T), usage);
 
                 // need to reattach
                 if (_type != shader_type::traits<T>::id ||
+                    _components_num != shader_type::traits<T>::components_num ||
                     _stride != sizeof(T) ||
                     _basic_type_size != sizeof(typename shader_type::traits<T>::basic_type) ||
                     _byte_offset != 0)
                 {
                     _type = shader_type::traits<T>::id;
+                    _components_num = shader_type::traits<T>::components_num;
                     _stride = sizeof(T);
                     _basic_type_size = sizeof(typename shader_type::traits<T>::basic_type);
                     _byte_offset = 0;
-                    return true;
+                    return format_changed;
                 }
             }
             else
-                return set(make_buffer(data, size, usage ? usage : GL_STATIC_DRAW),
-                           _divisor, 0, _normalize);
-            return false;
+                return reset<T>(make_buffer(data, size, usage ? usage : GL_STATIC_DRAW),
+                                sizeof(T), 0, _divisor, _normalize, true);
+            return unchanged;
+        }
+
+        /// @brief returns true if buffer was created by upload and it has no
+        /// owners except given number of attributes
+        bool owns_buffer(size_t attribs_num) const
+        {
+            return _owned && _buffer && attribs_num == size_t(_buffer.use_count());
+        }
+
+        /// @brief drop buffer, attribute array is disabled on next
+        /// specification
+        /// @return what was changed
+        change clear()
+        {
+            if (!_buffer)
+                return unchanged;
+            _buffer.reset();
+            _owned = false;
+            return format_changed;
+        }
+
+        /// @brief returns buffer
+        const buffer_base_ptr& buffer() const { return _buffer; }
+
+        /// @brief returns instance divisor and normalize flag
+        GLuint divisor() const { return _divisor; }
+        bool normalize() const { return _normalize; }
+
+        /// @brief returns location attribute is attached to, -1 if it isn't
+        GLint location() const { return _location; }
+
+        /// @brief uploads pending deferred updates of buffer
+        void flush() const
+        {
+            if (_buffer)
+                _buffer->flush();
+        }
+
+        /// @brief set location attribute is attached to
+        void locate(const GLint location) const
+        {
+            _location = location;
         }
 
-        /// @brief attach attrib, type unsafe, ensure that current attribute
-        /// is_glsl_convertible to ShaderType
+        /// @brief forget location attribute was attached to
+        void detach() const
+        {
+            _location = -1;
+        }
+
+        /// @brief specify attribute at its location, type unsafe, ensure that
+        /// current attribute is_glsl_convertible to ShaderType, vao should be
+        /// bound, unless direct state access is used, buffer should be bound
+        /// unless separate vertex format is used
         template<typename ShaderType>
-        void attach_unsafe(const GLint location) const
+        void specify(const GLuint vao) const
         {
             using namespace shader_type;
-            constexpr size_t locations_num  = traits<ShaderType>::locations_num;
-            constexpr size_t components_num = traits<ShaderType>::components_num;
+            constexpr GLint locations_num  = traits<ShaderType>::locations_num;
+            constexpr GLint components_num = traits<ShaderType>::components_num;
 
-            if (_buffer)
+            if (_location < 0)
+                return;
+            _locations_num = locations_num;
+            _location_size = components_num*_basic_type_size;
+
+#ifdef GLCXX_USE_VERTEX_ATTRIB_BINDING
+            if (has_vertex_attrib_binding())
             {
-                _buffer->bind();
-                for (size_t i = 0; i < locations_num; ++i)
+                for (GLint i = 0; i < locations_num; ++i)
+                {
+                    if (_buffer)
+                    {
+                        gl_enable_vertex_attrib(vao, _location + i);
+                        gl_vertex_attrib_format<ShaderType>(vao, _location + i, _components_num, _type, _normalize);
+                    }
+                    else
+                        gl_disable_vertex_attrib(vao, _location + i);
+                }
+                rebind(vao);
+                return;
+            }
+#else
+            (void)vao;
+#endif
+            for (GLint i = 0; i < locations_num; ++i)
+            {
+                if (_buffer)
                 {
-                    glEnableVertexAttribArray(location + i);
+                    glEnableVertexAttribArray(_location + i);
 
                     gl_vertex_attrib_pointer<ShaderType>(
-                        location + i, _type, _normalize, _stride,
-                        _byte_offset + i*components_num*_basic_type_size);
+                        _location + i, _components_num, _type, _normalize, _stride,
+                        _byte_offset + i*_location_size);
 
-                    glVertexAttribDivisor(location + i, _divisor);
+                    glVertexAttribDivisor(_location + i, _divisor);
                 }
-                _buffer->unbind();
-            }
-            else
-            {
-                for (GLint i = 0; i < shader_type::traits<ShaderType>::locations_num; ++i)
-                    glDisableVertexAttribArray(location + i);
+                else
+                    glDisableVertexAttribArray(_location + i);
             }
         }
+
+        /// @brief attach attrib to vao, type unsafe, ensure that current
+        /// attribute is_glsl_convertible to ShaderType
+        template<typename ShaderType>
+        void attach_unsafe(const GLuint vao, const GLint location) const
+        {
+            locate(location);
+            if (_buffer)
+                _buffer->bind();
+            specify<ShaderType>(vao);
+            if (_buffer)
+                _buffer->unbind();
+        }
+
+#ifdef GLCXX_USE_VERTEX_ATTRIB_BINDING
+        /// @brief rebind buffer of attached attribute to its binding points
+        /// after binding change, format remains intact, vao should be bound
+        /// unless direct state access is used
+        void rebind(const GLuint vao) const
+        {
+            if (_location < 0 || !_buffer)
+                return;
+            for (GLint i = 0; i < _locations_num; ++i)
+                gl_bind_vertex_buffer(vao, _location + i, _buffer->id(),
+                                      _byte_offset + i*_location_size, _stride, _divisor);
+        }
+#endif
     };
 }
 
@@ -22,8 +22,10 @@
 
 #include "glcxx/vao_base.hpp"
 #include "glcxx/shader_type.hpp"
+#include "glcxx/except.hpp"
 #include <memory>
 #include <vector>
+#include <cassert>
 
 namespace glcxx
 {
@@ -43,15 +45,45 @@ namespace glcxx
         /// @brief usage
         GLenum _usage;
 
+        /// @brief true if buffer was created while buffer pool was enabled,
+        /// such buffers keep storage of size class capacity and are parked in
+        /// the pool on destruction
+        bool _pooled = false;
+
+        /// @brief allocated storage size of pooled buffer
+        size_t _capacity = 0;
+
+        /// @brief deferred update not uploaded yet, bytes of range starting
+        /// at byte offset begin
+        struct pending_update
+        {
+            size_t begin;
+            std::vector<char> bytes;
+        };
+
+        /// @brief pending updates sorted by beginning, overlapping and
+        /// adjacent updates are merged, only updated bytes are kept, so
+        /// there is no copy of whole buffer and nothing is read back
+        std::vector<pending_update> _pending;
+
+        /// @brief uploads pending updates
+        void flush_pending();
+
+    protected:
+        /// @brief constructor, only generates buffer name, storage should be
+        /// allocated by derived class
+        explicit buffer_base(GLenum target);
+
+        /// @brief allocates immutable storage of given size and maps it
+        /// persistently, returns pointer to mapped memory
+        void* map_persistent_storage(size_t size, GLbitfield flags);
+
     public:
         /// @brief constructor
         buffer_base(const void* data, size_t size, GLenum usage, GLenum target);
 
-        /// @brief free buffer
-        ~buffer_base()
-        {
-            glDeleteBuffers(1, &_id);
-        }
+        /// @brief free buffer or park it in buffer pool
+        ~buffer_base();
 
         /// @brief binds buffer
         void bind() const
@@ -67,11 +99,146 @@ namespace glcxx
 
         /// @brief uploads new data to buffer, usage = 0 means do not change usage
         void upload(const void* data, size_t size, GLenum usage = 0);
+
+        /// @brief updates size bytes of buffer starting from byte_offset
+        void update(size_t byte_offset, const void* data, size_t size);
+
+        /// @brief records update of size bytes starting from byte_offset,
+        /// data is copied and actual upload is postponed until flush, update
+        /// overlapping or adjacent to pending one is merged with it and
+        /// uploaded with single call, never reads buffer back
+        void update_deferred(size_t byte_offset, const void* data, size_t size);
+
+        /// @brief uploads all deferred updates, called automatically before
+        /// draw calls using this buffer
+        void flush()
+        {
+            if (!_pending.empty())
+                flush_pending();
+        }
+
+        /// @brief maps size bytes of buffer starting from byte_offset, pending
+        /// deferred updates are flushed first
+        void* map(size_t byte_offset, size_t size, GLbitfield access);
+
+        /// @brief flushes size bytes of explicitly flushed mapping starting
+        /// from byte_offset relative to the beginning of mapping
+        void flush_mapped(size_t byte_offset, size_t size);
+
+        /// @brief unmaps buffer, returns false if data store was corrupted
+        /// while mapped and should be reuploaded
+        bool unmap();
+
+        /// @brief returns buffer id
+        GLuint id() const { return _id; }
+
+        /// @brief returns target
+        GLenum target() const { return _target; }
+    };
+
+    /// @brief base buffer ptr
+    using buffer_base_ptr = std::shared_ptr<buffer_base>;
+
+    /// @brief RAII typed view over mapped range of buffer, gives direct access
+    /// to driver memory, keeps buffer alive and unmaps it on destruction,
+    /// ranges mapped with GL_MAP_FLUSH_EXPLICIT_BIT are flushed as a whole on
+    /// unmapping unless flushed explicitly
+    template<typename Data>
+    class mapped_range
+    {
+        /// @brief disabled stuff
+        mapped_range(const mapped_range&) = delete;
+        mapped_range& operator=(const mapped_range&) = delete;
+
+        /// @brief mapped buffer, null if range was unmapped or moved from
+        buffer_base_ptr _buffer;
+
+        /// @brief mapped memory
+        Data* _data;
+
+        /// @brief element number
+        size_t _size;
+
+        /// @brief true if range should be flushed before unmapping
+        bool _flush;
+
+    public:
+        /// @brief constructor, throws buffer_error if mapping failed
+        mapped_range(buffer_base_ptr buf, size_t first, size_t size, GLbitfield access)
+            : _buffer(std::move(buf))
+            , _data(static_cast<Data*>(_buffer->map(first*sizeof(Data), size*sizeof(Data), access)))
+            , _size(size)
+            , _flush(access & GL_MAP_FLUSH_EXPLICIT_BIT)
+        {
+            if (!_data)
+                throw buffer_error("buffer range mapping failed");
+        }
+
+        /// @brief move constructor
+        mapped_range(mapped_range&& other) noexcept
+            : _buffer(std::move(other._buffer))
+            , _data(other._data)
+            , _size(other._size)
+            , _flush(other._flush)
+        {}
+
+        /// @brief move assignment, currently mapped range is unmapped first
+        mapped_range& operator=(mapped_range&& other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                _buffer = std::move(other._buffer);
+                _data = other._data;
+                _size = other._size;
+                _flush = other._flush;
+            }
+            return *this;
+        }
+
+        /// @brief destructor, result of unmapping is lost, call unmap
+        /// explicitly to detect data store corruption
+        ~mapped_range()
+        {
+            unmap();
+        }
+
+        /// @brief unmaps buffer, returns false if data store was corrupted
+        /// while mapped and data should be reuploaded, does nothing and
+        /// returns true if range isn't mapped
+        bool unmap()
+        {
+            if (!_buffer)
+                return true;
+            if (_flush)
+                _buffer->flush_mapped(0, _size*sizeof(Data));
+            const bool retval = _buffer->unmap();
+            _buffer.reset();
+            _data = nullptr;
+            return retval;
+        }
+
+        /// @brief explicitly flush size elements starting from first, only
+        /// valid for ranges mapped with GL_MAP_FLUSH_EXPLICIT_BIT
+        void flush(size_t first, size_t size)
+        {
+            assert(_buffer && first + size <= _size);
+            _buffer->flush_mapped(first*sizeof(Data), size*sizeof(Data));
+            _flush = false;
+        }
+
+        /// @brief element access
+        Data* data() const { return _data; }
+        size_t size() const { return _size; }
+        Data& operator[](size_t i) const { return _data[i]; }
+        Data* begin() const { return _data; }
+        Data* end() const { return _data + _size; }
     };
 
     /// @brief typesafe buffer object
     template<typename Data>
     class buffer : public buffer_base
+                 , public std::enable_shared_from_this<buffer<Data>>
     {
         /// @brief buffer element number
         GLsizei _size;
@@ -115,17 +282,75 @@ namespace glcxx
             upload(arr, N, usage);
         }
 
+        /// @brief updates size elements starting from element first
+        void update(size_t first, const Data* data, size_t size)
+        {
+            assert(first + size <= size_t(_size));
+            buffer_base::update(first*sizeof(Data), data, size*sizeof(Data));
+        }
+
+        /// @brief updates v.size() elements starting from element first
+        void update(size_t first, const std::vector<Data>& v) {
+            update(first, v.data(), v.size());
+        }
+
+        /// @brief records update of size elements starting from element
+        /// first, overlapping and adjacent updates are merged and uploaded
+        /// together before next draw call that uses this buffer
+        void update_deferred(size_t first, const Data* data, size_t size)
+        {
+            assert(first + size <= size_t(_size));
+            buffer_base::update_deferred(first*sizeof(Data), data, size*sizeof(Data));
+        }
+
+        /// @brief records update of v.size() elements starting from element first
+        void update_deferred(size_t first, const std::vector<Data>& v) {
+            update_deferred(first, v.data(), v.size());
+        }
+
+        /// @brief maps size elements starting from element first, by default
+        /// previous content of the range is discarded, add
+        /// GL_MAP_UNSYNCHRONIZED_BIT if range is known to be unused by gpu,
+        /// buffer should be owned by shared_ptr, e.g. created by make_buffer
+        mapped_range<Data> map(size_t first, size_t size,
+                               GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT)
+        {
+            assert(first + size <= size_t(_size));
+            return mapped_range<Data>(this->shared_from_this(), first, size, access);
+        }
+
         /// @brief returns element number
         GLsizei size() const { return _size; }
     };
 
-    /// @brief base buffer ptr
-    using buffer_base_ptr = std::shared_ptr<buffer_base>;
-
     /// @brief buffer ptr
     template<typename Data>
     using buffer_ptr = std::shared_ptr<buffer<Data>>;
 
+    /// @brief typed part of buffer, buffer with byte offset where elements of
+    /// type Data start, e.g. part of stream buffer reserved for current frame
+    template<typename Data>
+    struct buffer_range
+    {
+        /// @brief buffer this range belongs to
+        buffer_base_ptr buffer;
+
+        /// @brief byte offset of first element inside buffer
+        GLsizei byte_offset;
+
+        /// @brief element number
+        GLsizei size;
+
+        /// @brief index of first element inside buffer, e.g. base vertex of
+        /// mesh living in shared buffer, byte offset should be multiple of
+        /// element size, which holds for buffer_arena ranges
+        GLint first() const
+        {
+            assert(0 == byte_offset % sizeof(Data));
+            return byte_offset/sizeof(Data);
+        }
+    };
+
     /// @brief make buffer
     template<typename Data>
     inline buffer_ptr<Data> make_buffer(const Data* data, size_t size, GLenum usage = GL_STATIC_DRAW)
@@ -147,6 +372,13 @@ namespace glcxx
         return std::make_shared<buffer<Data>>(arr, N, usage);
     }
 
+    /// @brief tag requesting narrowing of indices to the smallest index type
+    /// that fits max index, e.g. uint indices of mesh with less than 65536
+    /// vertices are uploaded as ushort, shouldn't be used together with
+    /// primitive restart index of wider type
+    struct narrow_indices_t {};
+    constexpr narrow_indices_t narrow_indices{};
+
     /// @brief index buffer object, this buffer accepts ubyte, ushort and uint
     /// indices, also it saves mode, e.g. GL_TRIANGLE_STRIP
     class index_buffer : private buffer_base
@@ -185,6 +417,26 @@ namespace glcxx
             : index_buffer(arr, N, mode, usage)
         {}
 
+        /// @brief constructor, narrows indices, @see narrow_indices_t
+        template<typename T>
+        index_buffer(narrow_indices_t, const T* data, size_t size, GLenum mode, GLenum usage = GL_STATIC_DRAW)
+            : index_buffer(static_cast<const T*>(nullptr), 0, mode, usage)
+        {
+            upload(narrow_indices, data, size, mode);
+        }
+
+        /// @brief constructor, narrows indices, @see narrow_indices_t
+        template<typename T>
+        index_buffer(narrow_indices_t, const std::vector<T>& v, GLenum mode, GLenum usage = GL_STATIC_DRAW)
+            : index_buffer(narrow_indices, v.data(), v.size(), mode, usage)
+        {}
+
+        /// @brief constructor, narrows indices, @see narrow_indices_t
+        template<typename T, size_t N>
+        index_buffer(narrow_indices_t, const T (&arr)[N], GLenum mode, GLenum usage = GL_STATIC_DRAW)
+            : index_buffer(narrow_indices, arr, N, mode, usage)
+        {}
+
         /// @brief uploads new data to buffer
         template<typename T>
         void upload(const T* data, size_t size, GLenum mode, GLenum usage = 0)
@@ -209,6 +461,24 @@ namespace glcxx
             upload(arr, N, mode, usage);
         }
 
+        /// @brief uploads new data to buffer, narrows indices, @see narrow_indices_t
+        template<typename T>
+        void upload(narrow_indices_t, const T* data, size_t size, GLenum mode, GLenum usage = 0) {
+            upload_narrowed(data, size, mode, usage);
+        }
+
+        /// @brief uploads new data to buffer, narrows indices, @see narrow_indices_t
+        template<typename T>
+        void upload(narrow_indices_t, const std::vector<T>& v, GLenum mode, GLenum usage = 0) {
+            upload_narrowed(v.data(), v.size(), mode, usage);
+        }
+
+        /// @brief uploads new data to buffer, narrows indices, @see narrow_indices_t
+        template<typename T, size_t N>
+        void upload(narrow_indices_t, const T (&arr)[N], GLenum mode, GLenum usage = 0) {
+            upload_narrowed(arr, N, mode, usage);
+        }
+
         /// @brief draw with this index buffer
         void draw(const GLsizei instance_count) const
         {
@@ -218,13 +488,53 @@ namespace glcxx
                 glDrawElementsInstanced(_mode, _size, _type, nullptr, instance_count);
         }
 
+        /// @brief draw count indices starting from first_index, base_vertex is
+        /// added to each index, base_instance offsets instanced attributes
+        void draw(const GLsizei instance_count,
+                  const GLuint first_index,
+                  const GLsizei count,
+                  const GLint base_vertex,
+                  const GLuint base_instance) const
+        {
+            const size_t index_size = GL_UNSIGNED_BYTE == _type ? 1 : GL_UNSIGNED_SHORT == _type ? 2 : 4;
+            glDrawElementsInstancedBaseVertexBaseInstance(_mode, count, _type,
+                                                          reinterpret_cast<const void*>(first_index*index_size),
+                                                          -1 == instance_count ? 1 : instance_count,
+                                                          base_vertex, base_instance);
+        }
+
+        /// @brief returns number of indices
+        GLsizei size() const
+        {
+            return _size;
+        }
+
+        /// @brief draw draw_count commands from bound draw indirect buffer
+        /// starting at byte_offset with this index buffer
+        void multi_draw_indirect(const GLsizei draw_count, const GLintptr byte_offset = 0) const
+        {
+            glMultiDrawElementsIndirect(_mode, _type, reinterpret_cast<const void*>(byte_offset), draw_count, 0);
+        }
+
         using buffer_base::bind;
+        using buffer_base::flush;
+        using buffer_base::id;
 
         /// @brief unbind index buffer
         static void unbind()
         {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
+
+    private:
+        /// @brief scans indices for max value and uploads them using
+        /// narrowest fitting type
+        void upload_narrowed(const GLuint* data, size_t size, GLenum mode, GLenum usage);
+        void upload_narrowed(const GLushort* data, size_t size, GLenum mode, GLenum usage);
+        void upload_narrowed(const GLubyte* data, size_t size, GLenum mode, GLenum usage)
+        {
+            upload(data, size, mode, usage);
+        }
     };
 
     /// @brief index buffer ptr
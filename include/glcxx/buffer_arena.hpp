@@ -0,0 +1,125 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_BUFFER_ARENA_HPP
+#define GLCXX_BUFFER_ARENA_HPP
+
+#include "glcxx/buffer.hpp"
+#include <map>
+
+namespace glcxx
+{
+    /// @brief suballocator which keeps many logical buffers inside few large
+    /// buffer objects, every allocation is returned as buffer range, which
+    /// keeps its part of the arena alive while in use, so it could be passed to
+    /// vao::set just like buffer_ptr
+    class buffer_arena : public std::enable_shared_from_this<buffer_arena>
+    {
+        /// @brief disabled stuff
+        buffer_arena(const buffer_arena&) = delete;
+        buffer_arena& operator=(const buffer_arena&) = delete;
+
+        /// @brief single large buffer object with its free list
+        struct page
+        {
+            /// @brief buffer object
+            buffer_base_ptr buffer;
+
+            /// @brief free blocks, byte offset -> byte size, sorted by offset
+            /// so that neighbours can be coalesced on free
+            std::map<size_t, size_t> free_blocks;
+        };
+
+        /// @brief holds allocated block, returns it to arena on destruction
+        class allocation;
+
+        /// @brief byte size of regular page
+        size_t _page_size;
+
+        /// @brief usage of page buffers
+        GLenum _usage;
+
+        /// @brief target of page buffers
+        GLenum _target;
+
+        /// @brief pages
+        std::vector<page> _pages;
+
+        /// @brief allocates size bytes aligned to alignment, returns buffer
+        /// pointer sharing ownership of allocated block and block's offset
+        std::pair<buffer_base_ptr, size_t> allocate_bytes(size_t size, size_t alignment);
+
+        /// @brief returns block to free list of the page
+        void free_bytes(size_t page_index, size_t offset, size_t size);
+
+    public:
+        /// @brief constructor, allocations larger than page_size get
+        /// dedicated page
+        buffer_arena(size_t page_size = 4 << 20, GLenum usage = GL_STATIC_DRAW, GLenum target = GL_ARRAY_BUFFER);
+
+        /// @brief allocates uninitialized range of size elements, range
+        /// offset is multiple of sizeof(Data), so that ranges of same page
+        /// could also be addressed by base vertex
+        template<typename Data>
+        buffer_range<Data> allocate(size_t size)
+        {
+            constexpr size_t alignment = sizeof(Data) % 4 ? 4*sizeof(Data) : sizeof(Data);
+            auto block = allocate_bytes(size*sizeof(Data), alignment);
+            return {std::move(block.first), GLsizei(block.second), GLsizei(size)};
+        }
+
+        /// @brief allocates range and uploads data to it
+        template<typename Data>
+        buffer_range<Data> allocate(const Data* data, size_t size)
+        {
+            auto range = allocate<Data>(size);
+            range.buffer->update(range.byte_offset, data, size*sizeof(Data));
+            return range;
+        }
+
+        /// @brief allocates range and uploads data to it
+        template<typename Data>
+        buffer_range<Data> allocate(const std::vector<Data>& v)
+        {
+            return allocate(v.data(), v.size());
+        }
+
+        /// @brief allocates range and uploads data to it
+        template<typename Data, size_t N>
+        buffer_range<Data> allocate(const Data (&arr)[N])
+        {
+            return allocate(arr, N);
+        }
+
+        /// @brief returns number of buffer objects owned by arena
+        size_t pages_num() const { return _pages.size(); }
+    };
+
+    /// @brief buffer arena ptr
+    using buffer_arena_ptr = std::shared_ptr<buffer_arena>;
+
+    /// @brief make buffer arena
+    template<typename... Args>
+    inline buffer_arena_ptr make_buffer_arena(Args&&... args)
+    {
+        return std::make_shared<buffer_arena>(std::forward<Args>(args)...);
+    }
+}
+
+#endif
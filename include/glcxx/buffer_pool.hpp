@@ -0,0 +1,88 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_BUFFER_POOL_HPP
+#define GLCXX_BUFFER_POOL_HPP
+
+#include "glcxx/gl.hpp"
+#include <cstddef>
+
+namespace glcxx
+{
+    /// @brief optional pool recycling buffer objects, when enabled, buffers
+    /// created by make_buffer, make_index_buffer or buffer constructors
+    /// allocate storage rounded up to power of two size class, on destruction
+    /// buffer objects are parked with a fence instead of being deleted and are
+    /// reused by later requests of same size class and usage once gpu is done
+    /// with them
+    /// @note pool is a process-wide singleton without per-context separation,
+    /// parked buffers and fences belong to context that was current when they
+    /// were released, so pool should be used with single context or with
+    /// contexts sharing objects, disable should be called while that context
+    /// is still current
+    class buffer_pool
+    {
+    public:
+        /// @brief pool statistics
+        struct statistics
+        {
+            /// @brief number of requests satisfied by parked buffers
+            size_t hits = 0;
+
+            /// @brief number of requests that required new buffer
+            size_t misses = 0;
+
+            /// @brief number of currently parked buffers and their total size
+            size_t parked = 0;
+            size_t parked_bytes = 0;
+        };
+
+        /// @brief smallest size class
+        static constexpr size_t min_size_class = 256;
+
+        /// @brief enables pool, parked buffers above max_parked_bytes are
+        /// deleted starting from the oldest
+        static void enable(size_t max_parked_bytes = 64 << 20);
+
+        /// @brief disables pool and deletes all parked buffers, buffers which
+        /// are alive remain valid and get deleted as usual
+        static void disable();
+
+        /// @brief returns true if pool is enabled
+        static bool enabled();
+
+        /// @brief returns statistics
+        static const statistics& stats();
+
+        /// @brief resets hit/miss counters
+        static void reset_stats();
+
+        /// @brief returns size class for requested byte size
+        static size_t size_class(size_t size);
+
+        /// @brief returns parked buffer of given size class created with
+        /// given usage that isn't used by gpu anymore, 0 if there's none
+        static GLuint acquire(size_t size_class, GLenum usage);
+
+        /// @brief parks buffer of given size class and usage
+        static void release(GLuint id, size_t size_class, GLenum usage);
+    };
+}
+
+#endif
@@ -22,8 +22,61 @@
 
 #include "glcxx/gl.hpp"
 
+// direct state access vertex array functions use separate vertex format
+#if defined GLCXX_USE_DSA && !defined GLCXX_USE_VERTEX_ATTRIB_BINDING
+#define GLCXX_USE_VERTEX_ATTRIB_BINDING
+#endif
+
+// direct state access requires GL 4.5, which includes glProgramUniform*
+#if defined GLCXX_USE_DSA && !defined GLCXX_USE_PROGRAM_UNIFORM
+#define GLCXX_USE_PROGRAM_UNIFORM
+#endif
+
 namespace glcxx
 {
+#ifdef GLCXX_USE_DSA
+    /// @brief returns true if direct state access is supported by current
+    /// context, i.e. it's GL 4.5 or ARB_direct_state_access is present, result
+    /// is queried once and cached
+    bool has_dsa();
+#else
+    /// @brief direct state access code path is disabled at compile time
+    constexpr bool has_dsa()
+    {
+        return false;
+    }
+#endif
+
+#ifdef GLCXX_USE_VERTEX_ATTRIB_BINDING
+    /// @brief returns true if separate vertex format and buffer binding is
+    /// supported by current context, i.e. it's GL 4.3 or
+    /// ARB_vertex_attrib_binding is present, result is queried once and cached
+    bool has_vertex_attrib_binding();
+#else
+    /// @brief separate vertex format code path is disabled at compile time
+    constexpr bool has_vertex_attrib_binding()
+    {
+        return false;
+    }
+#endif
+
+#ifdef GLCXX_USE_PROGRAM_UNIFORM
+    /// @brief returns true if uniforms could be set without program
+    /// selection, i.e. it's GL 4.1 or ARB_separate_shader_objects is present,
+    /// result is queried once and cached
+    bool has_program_uniform();
+#else
+    /// @brief glProgramUniform* code path is disabled at compile time
+    constexpr bool has_program_uniform()
+    {
+        return false;
+    }
+#endif
+
+    /// @brief returns GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT of current context,
+    /// result is queried once and cached
+    GLint uniform_buffer_offset_alignment();
+
     /// @brief RAII style blending switch
     struct enable_blending_guard
     {
@@ -0,0 +1,115 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_COMPUTE_PROGRAM_HPP
+#define GLCXX_COMPUTE_PROGRAM_HPP
+
+#include "glcxx/program.hpp"
+
+namespace glcxx
+{
+    /// @brief compute program, consists of single compute shader
+    class compute_program_base : protected program_res_holder
+    {
+        /// @brief compute shader
+        shader _compute_shader;
+
+    public:
+        /// @brief constructor
+        compute_program_base(const std::string& glsl_version, const std::string& src);
+    };
+
+    namespace detail
+    {
+        /// @brief compute program impl
+        template<typename ProgramInputTuple>
+        class compute_program_impl;
+
+        /// @brief only tuple of program inputs is a valid parameter for compute
+        /// program, there is no vao_input as compute shaders have no vertex
+        /// stage, data is passed through uniforms and storage buffers
+        template<typename... ProgramInput>
+        class compute_program_impl<std::tuple<ProgramInput...>> : private compute_program_base, private ProgramInput...
+        {
+            /// @brief returns input type which has valid set<Name> method
+            template<typename Name>
+            using input_type = typename std::tuple_element<has_named_set_method<Name, std::tuple<ProgramInput...>>::index,
+                                                           std::tuple<ProgramInput...>>::type;
+
+            /// @brief returns argument type of set<Name> method found in input tuple
+            template<typename Name>
+            using set_arg_type = typename ct::function_traits<decltype(&input_type<Name>::template set<Name>)>::template arg_type<0>;
+
+            /// @brief inputs with values set after last dispatch, @see
+            /// program_impl
+            mutable std::bitset<sizeof...(ProgramInput)> _dirty;
+
+        public:
+            /// @brief ctstring containing glsl declarations of all program
+            /// inputs, declaration tags are ignored as there is single shader
+            using declarations = ct::string_cat<cts("\n"), typename ProgramInput::declaration...>;
+
+            /// @brief constructor
+            compute_program_impl(const std::string& name, const std::string& glsl_version, const std::string& src)
+                try : compute_program_base(glsl_version, program_base::prepend_header_to_program(name, declarations::chars, src))
+                    , ProgramInput(_object)...
+            {}
+            catch(glprogram_error& e) // add usefull info to exception and rethrow
+            {
+                e.prepend(name + " compute program failed:\n");
+                e.append(program_base::prepend_header_to_program(name, declarations::chars, src));
+                throw;
+            }
+
+            /// @brief @see program_res_holder::select
+            void select() const
+            {
+                compute_program_base::select();
+                glcxx_swallow(static_cast<const ProgramInput*>(this)->select());
+            }
+
+            /// @brief forward named set method to base class which has valid
+            /// definition of it, uniform values are flushed on dispatch
+            template<typename Name>
+            void set(set_arg_type<Name> value)
+            {
+                if (set_input<Name>(static_cast<input_type<Name>&>(*this), value, 0))
+                    _dirty.set(has_named_set_method<Name, std::tuple<ProgramInput...>>::index);
+            }
+
+            /// @brief selects program if needed and launches x*y*z work
+            /// groups, caller is responsible for glMemoryBarrier before
+            /// results are consumed
+            void dispatch(const GLuint x, const GLuint y = 1, const GLuint z = 1) const
+            {
+                if (!current())
+                    select();
+                if (_dirty.any())
+                    flush_inputs(_dirty, static_cast<const ProgramInput&>(*this)...);
+                glDispatchCompute(x, y, z);
+            }
+        };
+    }
+
+    /// @brief compute program shortcut
+    template<typename... Inputs>
+    using compute_program = detail::compute_program_impl<std::tuple<Inputs...>>;
+}
+
+#endif
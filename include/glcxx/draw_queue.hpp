@@ -0,0 +1,196 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_DRAW_QUEUE_HPP
+#define GLCXX_DRAW_QUEUE_HPP
+
+#include "glcxx/vao.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace glcxx
+{
+    /// @brief recorded draw command, type information of renderer, program and
+    /// vao is erased into draw function
+    struct draw_command
+    {
+        /// @brief sort key, @see draw_queue::make_key
+        uint64_t key;
+
+        /// @brief selects program, calls setup if requested and draws, vao is
+        /// bound only if it isn't bound already
+        void (*draw)(const draw_command& cmd, bool setup, bool vao_bound);
+
+        /// @brief renderer and vao
+        void* renderer;
+        const void* vao;
+
+        /// @brief optional per draw setup, e.g. setting uniforms and textures,
+        /// called with user pointer after program selection, skipped if
+        /// previous draw used same program, setup and user pointer
+        void (*setup)(const void* user);
+        const void* user;
+
+        /// @brief draw_arrays parameters
+        GLenum mode;
+        GLint first;
+        GLsizei size;
+    };
+
+    /// @brief queue of draw commands, commands are sorted by 64 bit key made
+    /// of program index, texture set, vao and depth and replayed with
+    /// redundant program switches, vao binds and setup calls removed
+    class draw_queue
+    {
+    public:
+        /// @brief statistics of last submit
+        struct statistics
+        {
+            /// @brief number of draw commands
+            size_t draws = 0;
+
+            /// @brief number of program switches done and avoided
+            size_t program_switches = 0;
+            size_t program_switches_avoided = 0;
+
+            /// @brief number of vao binds done and avoided
+            size_t vao_binds = 0;
+            size_t vao_binds_avoided = 0;
+
+            /// @brief number of setup calls done and avoided
+            size_t setups = 0;
+            size_t setups_avoided = 0;
+        };
+
+        /// @brief key bit layout from most to least significant bits
+        static constexpr unsigned program_bits     = 8;
+        static constexpr unsigned texture_set_bits = 16;
+        static constexpr unsigned vao_bits         = 16;
+        static constexpr unsigned depth_bits       = 24;
+
+        /// @brief builds sort key, non negative float depth is ordered by its
+        /// bit pattern, so it is used without normalization, texture set is
+        /// truncated, throws std::out_of_range if program index or vao id
+        /// doesn't fit its bits
+        static uint64_t make_key(size_t program_index, uint32_t texture_set, GLuint vao, float depth);
+
+        /// @brief record indexed draw of vao with given program of renderer
+        template<typename ProgramName, typename Renderer, typename... T>
+        void draw_elements(Renderer& renderer,
+                           const vao<T...>& vao,
+                           const float depth = 0.f,
+                           const uint32_t texture_set = 0,
+                           void (*setup)(const void*) = nullptr,
+                           const void* user = nullptr)
+        {
+            static_assert(Renderer::programs_num <= size_t(1) << program_bits, "too many programs for draw queue key");
+            _commands.push_back({make_key(Renderer::template program_index<ProgramName>(), texture_set, vao.id(), depth),
+                                 &draw_elements_impl<ProgramName, Renderer, glcxx::vao<T...>>,
+                                 &renderer, &vao, setup, user, 0, 0, 0});
+        }
+
+        /// @brief record non indexed draw of vao with given program of renderer
+        template<typename ProgramName, typename Renderer, typename... T>
+        void draw_arrays(Renderer& renderer,
+                         const vao<T...>& vao,
+                         const GLenum mode,
+                         const GLint first,
+                         const GLsizei size,
+                         const float depth = 0.f,
+                         const uint32_t texture_set = 0,
+                         void (*setup)(const void*) = nullptr,
+                         const void* user = nullptr)
+        {
+            static_assert(Renderer::programs_num <= size_t(1) << program_bits, "too many programs for draw queue key");
+            _commands.push_back({make_key(Renderer::template program_index<ProgramName>(), texture_set, vao.id(), depth),
+                                 &draw_arrays_impl<ProgramName, Renderer, glcxx::vao<T...>>,
+                                 &renderer, &vao, setup, user, mode, first, size});
+        }
+
+        /// @brief record type erased command, its draw function is called
+        /// during submit, vao may be null if command doesn't draw vao
+        void record(const draw_command& cmd)
+        {
+            _commands.push_back(cmd);
+        }
+
+        /// @brief sorts recorded commands, executes and clears them, vao and
+        /// buffers used by commands should not be changed by setup calls
+        void submit();
+
+        /// @brief drops recorded commands
+        void clear()
+        {
+            _commands.clear();
+        }
+
+        /// @brief returns number of recorded commands
+        size_t size() const
+        {
+            return _commands.size();
+        }
+
+        /// @brief returns statistics of last submit
+        const statistics& stats() const
+        {
+            return _stats;
+        }
+
+    private:
+        /// @brief sort item, command is referenced by index
+        struct sort_item
+        {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        /// @brief recorded commands
+        std::vector<draw_command> _commands;
+
+        /// @brief sort buffers, kept to avoid reallocation each frame
+        std::vector<sort_item> _order;
+        std::vector<sort_item> _tmp;
+
+        /// @brief statistics of last submit
+        statistics _stats;
+
+        /// @brief stable lsd radix sort of _order by key
+        void sort();
+
+        template<typename ProgramName, typename Renderer, typename Vao>
+        static void draw_elements_impl(const draw_command& cmd, const bool setup, const bool vao_bound)
+        {
+            auto& program = static_cast<Renderer*>(cmd.renderer)->template program<ProgramName>();
+            if (setup && cmd.setup)
+                cmd.setup(cmd.user);
+            program.draw_elements_bound(*static_cast<const Vao*>(cmd.vao), vao_bound);
+        }
+
+        template<typename ProgramName, typename Renderer, typename Vao>
+        static void draw_arrays_impl(const draw_command& cmd, const bool setup, const bool vao_bound)
+        {
+            auto& program = static_cast<Renderer*>(cmd.renderer)->template program<ProgramName>();
+            if (setup && cmd.setup)
+                cmd.setup(cmd.user);
+            program.draw_arrays_bound(*static_cast<const Vao*>(cmd.vao), cmd.mode, cmd.first, cmd.size, vao_bound);
+        }
+    };
+}
+
+#endif
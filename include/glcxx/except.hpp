@@ -54,6 +54,13 @@ namespace glcxx
     {
         using glprogram_error::glprogram_error;
     };
+
+    /// @brief thrown when buffer memory cannot be provided, e.g. stream
+    /// buffer partition overflow
+    struct buffer_error : std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
 }
 
 #endif
@@ -0,0 +1,186 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_FRUSTUM_CULLING_HPP
+#define GLCXX_FRUSTUM_CULLING_HPP
+
+#include "glcxx/instance_stream.hpp"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace glcxx
+{
+    /// @brief view frustum planes, point p is inside plane if
+    /// dot(plane.xyz, p) + plane.w >= 0, planes are normalized
+    struct frustum
+    {
+        /// @brief left, right, bottom, top, near and far planes
+        std::array<glm::vec4, 6> planes;
+
+        /// @brief extracts planes from view-projection matrix
+        explicit frustum(const glm::mat4& view_projection);
+    };
+
+    /// @brief bounding spheres stored as structure of arrays
+    struct bounding_spheres
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+
+        /// @brief append sphere
+        void push(const glm::vec3& center, float r)
+        {
+            x.push_back(center.x);
+            y.push_back(center.y);
+            z.push_back(center.z);
+            radius.push_back(r);
+        }
+
+        /// @brief returns number of spheres
+        size_t size() const
+        {
+            return x.size();
+        }
+
+        /// @brief remove all spheres
+        void clear()
+        {
+            x.clear();
+            y.clear();
+            z.clear();
+            radius.clear();
+        }
+    };
+
+    /// @brief axis aligned bounding boxes stored as structure of arrays
+    struct bounding_boxes
+    {
+        std::vector<float> min_x;
+        std::vector<float> min_y;
+        std::vector<float> min_z;
+        std::vector<float> max_x;
+        std::vector<float> max_y;
+        std::vector<float> max_z;
+
+        /// @brief append box
+        void push(const glm::vec3& min, const glm::vec3& max)
+        {
+            min_x.push_back(min.x);
+            min_y.push_back(min.y);
+            min_z.push_back(min.z);
+            max_x.push_back(max.x);
+            max_y.push_back(max.y);
+            max_z.push_back(max.z);
+        }
+
+        /// @brief returns number of boxes
+        size_t size() const
+        {
+            return min_x.size();
+        }
+
+        /// @brief remove all boxes
+        void clear()
+        {
+            min_x.clear();
+            min_y.clear();
+            min_z.clear();
+            max_x.clear();
+            max_y.clear();
+            max_z.clear();
+        }
+    };
+
+    /// @brief tests bounds [first, last) against frustum and writes indices of
+    /// visible ones to visible, returns their number, uses AVX2 or SSE2
+    /// kernels if enabled at compile time, test is conservative, i.e. bounds
+    /// intersecting frustum are reported visible
+    size_t cull(const frustum& f, const bounding_spheres& bounds, size_t first, size_t last, uint32_t* visible);
+    size_t cull(const frustum& f, const bounding_boxes& bounds, size_t first, size_t last, uint32_t* visible);
+
+    /// @brief frustum culling stage, splits large sets across persistent
+    /// worker threads, keeps its output storage between frames, visible
+    /// instances may be packed directly into instance_stream
+    class frustum_culler
+    {
+        /// @brief indices of visible bounds of last cull
+        std::vector<uint32_t> _visible;
+
+        /// @brief visible bounds number of every chunk of last parallel cull
+        std::vector<size_t> _counts;
+
+        /// @brief max number of threads
+        size_t _threads_num;
+
+        /// @brief worker threads, started on first parallel cull
+        struct worker_pool;
+        std::unique_ptr<worker_pool> _pool;
+
+    public:
+        /// @brief min number of bounds processed by single thread
+        static constexpr size_t min_bounds_per_thread = 16384;
+
+        /// @brief constructor, 0 threads means hardware concurrency
+        explicit frustum_culler(size_t threads_num = 0);
+
+        /// @brief destructor, stops worker threads
+        ~frustum_culler();
+
+        /// @brief movable
+        frustum_culler(frustum_culler&&) noexcept;
+        frustum_culler& operator=(frustum_culler&&) noexcept;
+
+        /// @brief cull bounds, returns number of visible ones, @see visible
+        size_t cull(const frustum& f, const bounding_spheres& bounds);
+        size_t cull(const frustum& f, const bounding_boxes& bounds);
+
+        /// @brief indices of visible bounds of last cull
+        const uint32_t* visible() const
+        {
+            return _visible.data();
+        }
+
+        /// @brief cull bounds and push instances of visible ones into stream,
+        /// instances[i] corresponds to bounds i, returns number of visible
+        /// instances, stream's submit then sets vao instance count, throws
+        /// buffer_error if visible instances don't fit stream's frame, so its
+        /// capacity should cover all instances which may be visible
+        template<typename Bounds, typename Data>
+        size_t cull(const frustum& f, const Bounds& bounds, const Data* instances, instance_stream<Data>& stream)
+        {
+            const size_t visible_num = cull(f, bounds);
+            Data* dst = stream.push(visible_num);
+            for (size_t i = 0; i < visible_num; ++i)
+                dst[i] = instances[_visible[i]];
+            return visible_num;
+        }
+
+    private:
+        /// @brief runs kernel over chunks in parallel and compacts output
+        template<typename Bounds>
+        size_t cull_parallel(const frustum& f, const Bounds& bounds);
+    };
+}
+
+#endif
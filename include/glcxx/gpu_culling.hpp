@@ -0,0 +1,164 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_GPU_CULLING_HPP
+#define GLCXX_GPU_CULLING_HPP
+
+#include "glcxx/compute_program.hpp"
+#include "glcxx/frustum_culling.hpp"
+#include "glcxx/indirect_batch.hpp"
+#include "glcxx/storage_buffer_input.hpp"
+#include "glcxx/uniform.hpp"
+
+namespace glcxx
+{
+    /// @brief frustum culling on gpu, compute shader tests bounding sphere of
+    /// each instance and appends visible instances to compacted buffer,
+    /// incrementing instance count of indirect draw command, so that culling
+    /// result is consumed by indirect draw without cpu readback, requires
+    /// GL 4.3, Instance should be glsl type, e.g. model matrix, whose std430
+    /// array stride matches its size, i.e. scalars, 2 component vectors, 4
+    /// component vectors and matrices of them, but not vec3 or mat3
+    template<typename Instance = glm::mat4>
+    class gpu_culler
+    {
+        // std430 pads 3 component vectors to 16 bytes, so array of Instance
+        // would be laid out differently on gpu than in vertex buffer
+        static_assert(sizeof(Instance) % 16 == 0 || sizeof(Instance) <= 8,
+                      "instance size doesn't match its std430 array stride");
+
+        /// @brief work group size
+        static constexpr GLuint local_size = 64;
+
+        /// @brief culling program
+        using program_t = compute_program<uniform<cts("planes"), std::array<glm::vec4, 6>>,
+                                          uniform<cts("bounds_num"), GLuint>,
+                                          storage_buffer_input<cts("bounds"), glm::vec4, 0>,
+                                          storage_buffer_input<cts("instances"), Instance, 1>,
+                                          storage_buffer_input<cts("visible"), Instance, 2>,
+                                          storage_buffer_input<cts("command"), GLuint, 3>>;
+        program_t _program;
+
+        /// @brief bounding spheres, xyz is center and w is radius
+        buffer_ptr<glm::vec4> _bounds;
+
+        /// @brief all instances
+        buffer_ptr<Instance> _instances;
+
+        /// @brief compacted visible instances, grows but never shrinks
+        buffer_ptr<Instance> _visible;
+
+        /// @brief single indirect draw command
+        buffer_ptr<draw_elements_indirect_command> _command;
+
+        /// @brief number of uploaded instances
+        GLuint _size = 0;
+
+        /// @brief compute shader source
+        static const char* source()
+        {
+            return
+                "layout(local_size_x = 64) in;\n"
+                "void main()\n"
+                "{\n"
+                "    uint i = gl_GlobalInvocationID.x;\n"
+                "    if (i >= bounds_num)\n"
+                "        return;\n"
+                "    vec4 sphere = bounds[i];\n"
+                "    for (int p = 0; p < 6; ++p)\n"
+                "        if (dot(planes[p].xyz, sphere.xyz) + planes[p].w < -sphere.w)\n"
+                "            return;\n"
+                "    visible[atomicAdd(command[1], 1u)] = instances[i];\n"
+                "}\n";
+        }
+
+    public:
+        /// @brief constructor, compute shaders require at least glsl 430
+        explicit gpu_culler(const std::string& glsl_version = "#version 430 core")
+            : _program("gpu_culler", glsl_version, source())
+            , _bounds(make_buffer<glm::vec4>(nullptr, 0, GL_STATIC_DRAW))
+            , _instances(make_buffer<Instance>(nullptr, 0, GL_STATIC_DRAW))
+            , _visible(make_buffer<Instance>(nullptr, 0, GL_DYNAMIC_COPY))
+            , _command(std::make_shared<buffer<draw_elements_indirect_command>>(nullptr, 1, GL_DYNAMIC_DRAW,
+                                                                                 GL_DRAW_INDIRECT_BUFFER))
+        {}
+
+        /// @brief uploads bounding spheres and instances, buffer objects are
+        /// reused, so visible() remains attached to vaos
+        void upload(const glm::vec4* spheres, const Instance* instances, const size_t size)
+        {
+            _bounds->upload(spheres, size);
+            _instances->upload(instances, size);
+            if (size_t(_visible->size()) < size)
+                _visible->upload(static_cast<const Instance*>(nullptr), size);
+            _size = size;
+        }
+
+        /// @brief uploads bounding spheres and instances
+        void upload(const bounding_spheres& spheres, const std::vector<Instance>& instances)
+        {
+            assert(spheres.size() == instances.size());
+            std::vector<glm::vec4> packed(spheres.size());
+            for (size_t i = 0; i < packed.size(); ++i)
+                packed[i] = glm::vec4(spheres.x[i], spheres.y[i], spheres.z[i], spheres.radius[i]);
+            upload(packed.data(), instances.data(), packed.size());
+        }
+
+        /// @brief culls uploaded instances, resets indirect command to draw
+        /// index_count indices starting from first_index and lets gpu fill
+        /// its instance count
+        void cull(const frustum& f, const GLuint index_count, const GLuint first_index = 0, const GLint base_vertex = 0)
+        {
+            const draw_elements_indirect_command cmd{index_count, 0, first_index, base_vertex, 0};
+            _command->update(0, &cmd, 1);
+
+            _program.template set<cts("planes")>(f.planes);
+            _program.template set<cts("bounds_num")>(_size);
+            _program.template set<cts("bounds")>(_bounds);
+            _program.template set<cts("instances")>(_instances);
+            _program.template set<cts("visible")>(_visible);
+            _program.template set<cts("command")>(_command);
+            _program.dispatch((_size + local_size - 1)/local_size);
+
+            // results are consumed as draw command and instanced attributes,
+            // command is reset by buffer update of next cull or read back
+            glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        }
+
+        /// @brief compacted visible instances, attach to vao with divisor 1
+        const buffer_ptr<Instance>& visible() const
+        {
+            return _visible;
+        }
+
+        /// @brief indirect draw command written by cull
+        const buffer_ptr<draw_elements_indirect_command>& command() const
+        {
+            return _command;
+        }
+
+        /// @brief returns number of uploaded instances
+        size_t size() const
+        {
+            return _size;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,41 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_INDICES_HPP
+#define GLCXX_INDICES_HPP
+
+#include "glcxx/gl.hpp"
+#include <cstddef>
+
+namespace glcxx
+{
+    /// @brief returns max value of indices, 0 for empty range, uses AVX2 or
+    /// SSE2 kernels if enabled at compile time
+    GLuint max_index(const GLuint* data, size_t size);
+    GLuint max_index(const GLushort* data, size_t size);
+    GLuint max_index(const GLubyte* data, size_t size);
+
+    /// @brief converts indices to narrower type, all indices should fit into
+    /// destination type, uses AVX2 or SSE2 kernels if enabled at compile time
+    void convert_indices(const GLuint* src, size_t size, GLushort* dst);
+    void convert_indices(const GLuint* src, size_t size, GLubyte* dst);
+    void convert_indices(const GLushort* src, size_t size, GLubyte* dst);
+}
+
+#endif
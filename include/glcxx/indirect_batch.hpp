@@ -0,0 +1,126 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_INDIRECT_BATCH_HPP
+#define GLCXX_INDIRECT_BATCH_HPP
+
+#include "glcxx/buffer.hpp"
+#include <vector>
+
+namespace glcxx
+{
+    /// @brief layout of DrawElementsIndirectCommand
+    struct draw_elements_indirect_command
+    {
+        GLuint count;
+        GLuint instance_count;
+        GLuint first_index;
+        GLint  base_vertex;
+        GLuint base_instance;
+    };
+
+    /// @brief layout of DrawArraysIndirectCommand
+    struct draw_arrays_indirect_command
+    {
+        GLuint count;
+        GLuint instance_count;
+        GLuint first;
+        GLuint base_instance;
+    };
+
+    /// @brief batch of indirect draw commands sharing program and vao, which
+    /// is submitted by single glMultiDraw*Indirect call, e.g. for many meshes
+    /// living in shared vertex and index buffers
+    template<typename Command>
+    class indirect_batch
+    {
+        /// @brief recorded commands
+        std::vector<Command> _commands;
+
+        /// @brief draw indirect buffer, created on first submission
+        buffer_base_ptr _buffer;
+
+        /// @brief true if commands were changed since last upload
+        bool _dirty = true;
+
+    public:
+        /// @brief command type
+        using command = Command;
+
+        /// @brief append command
+        void add(const Command& cmd)
+        {
+            _commands.push_back(cmd);
+            _dirty = true;
+        }
+
+        /// @brief drop all commands, buffer is kept for reuse
+        void clear()
+        {
+            _commands.clear();
+            _dirty = true;
+        }
+
+        /// @brief returns number of commands
+        size_t size() const
+        {
+            return _commands.size();
+        }
+
+        /// @brief returns true if there are no commands
+        bool empty() const
+        {
+            return _commands.empty();
+        }
+
+        /// @brief returns commands
+        const std::vector<Command>& commands() const
+        {
+            return _commands;
+        }
+
+        /// @brief uploads commands to draw indirect buffer if they were changed
+        /// since last upload and binds it, so static batch is uploaded once
+        void bind()
+        {
+            if (_dirty)
+            {
+                const size_t bytes = _commands.size()*sizeof(Command);
+                if (_buffer)
+                    _buffer->upload(_commands.data(), bytes);
+                else
+                    _buffer = std::make_shared<buffer_base>(_commands.data(), bytes, GL_STREAM_DRAW, GL_DRAW_INDIRECT_BUFFER);
+                _dirty = false;
+            }
+            _buffer->bind();
+        }
+
+        /// @brief unbinds draw indirect buffer
+        static void unbind()
+        {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+    };
+
+    /// @brief batch shortcuts
+    using elements_batch = indirect_batch<draw_elements_indirect_command>;
+    using arrays_batch   = indirect_batch<draw_arrays_indirect_command>;
+}
+
+#endif
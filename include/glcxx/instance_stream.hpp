@@ -0,0 +1,155 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_INSTANCE_STREAM_HPP
+#define GLCXX_INSTANCE_STREAM_HPP
+
+#include "glcxx/except.hpp"
+#include "glcxx/stream_buffer.hpp"
+#include "glcxx/vao.hpp"
+
+namespace glcxx
+{
+    /// @brief per frame instance data packed directly into persistently mapped
+    /// stream buffer, instances are pushed every frame and submit attaches
+    /// them to vao attributes with divisor 1 and sets vao instance count,
+    /// matrices span several locations as usual, no heap allocation happens
+    /// after construction, every frame should be finished by end_frame after
+    /// all draws using its instances were issued
+    template<typename Data>
+    class instance_stream
+    {
+        /// @brief underlying stream buffer
+        stream_buffer_ptr<Data> _buffer;
+
+        /// @brief max instance number per frame
+        size_t _capacity;
+
+        /// @brief range reserved for current frame
+        buffer_range<Data> _range;
+
+        /// @brief mapped memory of current frame, null if frame isn't started
+        Data* _data = nullptr;
+
+        /// @brief number of instances pushed in current frame
+        size_t _size = 0;
+
+        /// @brief index of first instance which wasn't submitted yet
+        size_t _first = 0;
+
+        /// @brief reserves range for new frame in current partition
+        void start_frame()
+        {
+            _range = _buffer->allocate(_capacity);
+            _data = _buffer->pointer(_range);
+            _size = 0;
+            _first = 0;
+        }
+
+        /// @brief attach whole instance struct to single attribute
+        template<typename AttribName, typename... T>
+        void attach(vao<T...>& vao, buffer_range<Data> range)
+        {
+            vao.template set<AttribName>(std::move(range), 1u);
+        }
+
+        /// @brief attach instance struct members to attributes
+        template<typename... AttribName, typename... T, typename... Member>
+        void attach(vao<T...>& vao, const buffer_range<Data>& range, Member Data::*... members)
+        {
+            glcxx_swallow(vao.template set<AttribName>(range, members, 1u));
+        }
+
+    public:
+        /// @brief constructor
+        /// @param capacity max instance number pushed per frame
+        explicit instance_stream(size_t capacity)
+            : _buffer(make_stream_buffer<Data>(capacity, GL_ARRAY_BUFFER))
+            , _capacity(capacity)
+            , _range{nullptr, 0, 0}
+        {}
+
+        /// @brief push single instance, throws buffer_error if frame has no
+        /// space left
+        void push(const Data& instance)
+        {
+            *push(1) = instance;
+        }
+
+        /// @brief reserve size instances, returns pointer to fill them, throws
+        /// buffer_error if frame has no space left, as writing past reserved
+        /// range would overwrite partition gpu may still read
+        Data* push(size_t size)
+        {
+            if (!_data)
+                start_frame();
+            if (_size + size > _capacity)
+                throw buffer_error("instance stream overflow");
+            Data* retval = _data + _size;
+            _size += size;
+            return retval;
+        }
+
+        /// @brief returns number of instances pushed in current frame
+        size_t size() const
+        {
+            return _size;
+        }
+
+        /// @brief returns max instance number per frame
+        size_t capacity() const
+        {
+            return _capacity;
+        }
+
+        /// @brief attaches instances pushed since previous submit of current
+        /// frame to vao and sets its instance count, without members whole
+        /// instance struct is attached to single attribute, otherwise members
+        /// are attached to attributes AttribName... in order, several vaos
+        /// may be submitted per frame
+        template<typename... AttribName, typename... T, typename... Member>
+        void submit(vao<T...>& vao, Member Data::*... members)
+        {
+            static_assert(sizeof...(AttribName) == std::max<size_t>(sizeof...(Member), 1),
+                          "attribute number doesn't match member number");
+            if (!_data)
+                start_frame();
+            attach<AttribName...>(vao, buffer_range<Data>{_range.buffer, GLsizei(_range.byte_offset + _first*sizeof(Data)),
+                                                         GLsizei(_size - _first)}, members...);
+            vao.instance_count(_size - _first);
+            _first = _size;
+        }
+
+        /// @brief finishes frame, fences its partition and switches to next
+        /// one, should be called once per frame after all draws using
+        /// submitted instances were issued, otherwise next frame overwrites
+        /// data gpu may still read, or fails with buffer_error if partition
+        /// has no space left, next push starts new frame
+        void end_frame()
+        {
+            if (_data)
+            {
+                _buffer->next_partition();
+                _data = nullptr;
+            }
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_INTERLEAVE_HPP
+#define GLCXX_INTERLEAVE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace glcxx
+{
+    /// @brief single source stream of interleave kernel
+    struct interleave_stream
+    {
+        /// @brief tightly packed source elements
+        const void* src;
+
+        /// @brief element byte size
+        size_t size;
+
+        /// @brief byte offset of element inside interleaved vertex
+        size_t offset;
+    };
+
+    /// @brief scatters count elements of every stream into dst with given
+    /// stride, copies of 4, 8, 12 and 16 byte elements use SSE2 if enabled at
+    /// compile time
+    void interleave(void* dst, size_t stride, size_t count, const interleave_stream* streams, size_t streams_num);
+
+    /// @brief compile time layout of interleaved vertex made of T..., every
+    /// member is aligned to 4 bytes as recommended for vertex attributes
+    template<typename... T>
+    struct interleaved_layout
+    {
+        /// @brief byte sizes of members
+        static constexpr size_t sizes[] = {sizeof(T)...};
+
+        /// @brief member byte offset
+        static constexpr size_t offset(size_t index)
+        {
+            size_t retval = 0;
+            for (size_t i = 0; i < index; ++i)
+                retval += (sizes[i] + 3)/4*4;
+            return retval;
+        }
+
+        /// @brief vertex byte size
+        static constexpr size_t stride = offset(sizeof...(T));
+    };
+
+    /// @brief this definition is required for odr-usage
+    template<typename... T>
+    constexpr size_t interleaved_layout<T...>::sizes[];
+
+    /// @brief interleaves streams into single byte vector using layout of
+    /// their element types, throws std::invalid_argument if streams have
+    /// different sizes
+    template<typename... T>
+    std::vector<char> interleave(const std::vector<T>&... streams)
+    {
+        using layout = interleaved_layout<T...>;
+        const size_t count = std::min({streams.size()...});
+        if (count != std::max({streams.size()...}))
+            throw std::invalid_argument("interleaved streams have different sizes");
+        const interleave_stream desc[] = {{streams.data(), sizeof(T), 0}...};
+        interleave_stream layout_desc[sizeof...(T)];
+        for (size_t i = 0; i < sizeof...(T); ++i)
+            layout_desc[i] = {desc[i].src, desc[i].size, layout::offset(i)};
+
+        std::vector<char> retval(count*layout::stride);
+        interleave(retval.data(), layout::stride, count, layout_desc, sizeof...(T));
+        return retval;
+    }
+}
+
+#endif
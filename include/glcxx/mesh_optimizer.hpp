@@ -0,0 +1,89 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_MESH_OPTIMIZER_HPP
+#define GLCXX_MESH_OPTIMIZER_HPP
+
+#include "glcxx/gl.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace glcxx
+{
+    /// @brief mesh optimization routines for triangle lists, they work on
+    /// same index vectors that index_buffer and vao::upload_indices accept,
+    /// supported index types are GLubyte, GLushort and GLuint
+
+    /// @brief post-transform vertex cache simulation results
+    struct vertex_cache_statistics
+    {
+        /// @brief number of vertex shader invocations
+        size_t vertices_transformed = 0;
+
+        /// @brief average cache miss ratio, transformed vertices per triangle,
+        /// 0.5 is ideal for regular grids, 3 is the worst
+        float acmr = 0.f;
+
+        /// @brief average transformed to vertex ratio, 1 is ideal
+        float atvr = 0.f;
+    };
+
+    /// @brief simulates fifo post-transform vertex cache of given size
+    template<typename T>
+    vertex_cache_statistics analyze_vertex_cache(const std::vector<T>& indices, size_t vertex_num, size_t cache_size = 16);
+
+    /// @brief reorders triangles for post-transform vertex cache locality
+    /// using Forsyth's linear-speed vertex cache optimization
+    template<typename T>
+    void optimize_vertex_cache(std::vector<T>& indices, size_t vertex_num, size_t cache_size = 32);
+
+    /// @brief reorders clusters of vertex cache optimized triangles to reduce
+    /// overdraw, clusters facing outwards are drawn first as they are the most
+    /// likely occluders from any view point, cluster is split once its acmr
+    /// drops to threshold times acmr of whole mesh, so threshold above 1
+    /// trades some vertex cache efficiency for smaller clusters
+    template<typename T>
+    void optimize_overdraw(std::vector<T>& indices, const std::vector<glm::vec3>& positions,
+                           float threshold = 1.05f, size_t cache_size = 16);
+
+    /// @brief renumbers vertices in order of their first use by indices,
+    /// updates indices accordingly, returns remap table old index -> new
+    /// index, which should be applied to every vertex stream with
+    /// remap_vertices, unused vertices are mapped to ~0u and dropped
+    template<typename T>
+    std::vector<GLuint> optimize_vertex_fetch(std::vector<T>& indices, size_t vertex_num);
+
+    /// @brief applies remap table returned by optimize_vertex_fetch to vertex
+    /// stream
+    template<typename Vertex>
+    std::vector<Vertex> remap_vertices(const std::vector<Vertex>& vertices, const std::vector<GLuint>& remap)
+    {
+        size_t size = 0;
+        for (auto r : remap)
+            if (~0u != r && r >= size)
+                size = r + 1;
+        std::vector<Vertex> retval(size);
+        for (size_t i = 0; i < remap.size(); ++i)
+            if (~0u != remap[i])
+                retval[remap[i]] = vertices[i];
+        return retval;
+    }
+}
+
+#endif
@@ -0,0 +1,166 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_PACKED_TYPES_HPP
+#define GLCXX_PACKED_TYPES_HPP
+
+#include "glcxx/shader_type.hpp"
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+namespace glcxx
+{
+    /// @brief compact host types for vertex attributes, they are uploaded as
+    /// is and are expanded to float vectors by vertex fetch, so they are
+    /// glsl convertible to corresponding float shader types
+
+    namespace detail
+    {
+        /// @brief true if T is float vector of 2 to N components
+        template<typename T, size_t N> struct is_float_vec_upto : std::false_type {};
+        template<size_t N> struct is_float_vec_upto<glm::vec2, N> : std::integral_constant<bool, 2 <= N> {};
+        template<size_t N> struct is_float_vec_upto<glm::vec3, N> : std::integral_constant<bool, 3 <= N> {};
+        template<size_t N> struct is_float_vec_upto<glm::vec4, N> : std::integral_constant<bool, 4 <= N> {};
+
+        /// @brief float vector of N components
+        template<size_t N> struct float_vec;
+        template<> struct float_vec<2> { using type = glm::vec2; };
+        template<> struct float_vec<3> { using type = glm::vec3; };
+        template<> struct float_vec<4> { using type = glm::vec4; };
+    }
+
+    /// @brief conversions between float and half
+    GLushort float_to_half(float f);
+    float half_to_float(GLushort h);
+
+    /// @brief N component half precision float vector, GL_HALF_FLOAT
+    template<size_t N>
+    struct half_vec
+    {
+        GLushort bits[N];
+
+        /// @brief decode, extra components are dropped
+        template<typename T, typename = std::enable_if_t<detail::is_float_vec_upto<T, N>::value>>
+        explicit operator T() const
+        {
+            T retval;
+            for (GLint i = 0; i < shader_type::traits<T>::components_num; ++i)
+                retval[i] = half_to_float(bits[i]);
+            return retval;
+        }
+    };
+    using half2 = half_vec<2>;
+    using half3 = half_vec<3>;
+    using half4 = half_vec<4>;
+
+    /// @brief signed normalized 10:10:10:2 vector, GL_INT_2_10_10_10_REV, x
+    /// is stored in lowest bits, convertible to vec3 and vec4
+    struct int_2_10_10_10_rev
+    {
+        GLuint bits;
+
+        /// @brief decode
+        explicit operator glm::vec4() const;
+        explicit operator glm::vec3() const;
+    };
+
+    /// @brief N component normalized integer vector, e.g. signed bytes are
+    /// mapped to [-1,1], unsigned shorts to [0,1], to be uploaded with
+    /// normalize flag set, which is default
+    template<typename T, size_t N>
+    struct normalized_vec
+    {
+        T values[N];
+
+        /// @brief decode, extra components are dropped
+        template<typename U, typename = std::enable_if_t<detail::is_float_vec_upto<U, N>::value>>
+        explicit operator U() const
+        {
+            constexpr float max = float(std::numeric_limits<T>::max());
+            U retval;
+            for (GLint i = 0; i < shader_type::traits<U>::components_num; ++i)
+                retval[i] = std::max(values[i]/max, -1.f);
+            return retval;
+        }
+    };
+    using snorm8x2  = normalized_vec<GLbyte, 2>;
+    using snorm8x4  = normalized_vec<GLbyte, 4>;
+    using unorm8x2  = normalized_vec<GLubyte, 2>;
+    using unorm8x4  = normalized_vec<GLubyte, 4>;
+    using snorm16x2 = normalized_vec<GLshort, 2>;
+    using snorm16x4 = normalized_vec<GLshort, 4>;
+    using unorm16x2 = normalized_vec<GLushort, 2>;
+    using unorm16x4 = normalized_vec<GLushort, 4>;
+
+    /// @brief converters from float arrays into packed formats, use F16C,
+    /// SSE2 kernels if enabled at compile time
+    void pack_half(const float* src, size_t size, GLushort* dst);
+    void pack_int_2_10_10_10_rev(const glm::vec4* src, size_t size, int_2_10_10_10_rev* dst);
+    void pack_int_2_10_10_10_rev(const glm::vec3* src, size_t size, int_2_10_10_10_rev* dst);
+    void pack_normalized(const float* src, size_t size, GLbyte* dst);
+    void pack_normalized(const float* src, size_t size, GLubyte* dst);
+    void pack_normalized(const float* src, size_t size, GLshort* dst);
+    void pack_normalized(const float* src, size_t size, GLushort* dst);
+
+    /// @brief typed shortcuts packing vectors
+    template<size_t N>
+    inline void pack(const float* src, size_t size, half_vec<N>* dst)
+    {
+        pack_half(src, size*N, dst->bits);
+    }
+
+    template<typename T, size_t N>
+    inline void pack(const float* src, size_t size, normalized_vec<T, N>* dst)
+    {
+        pack_normalized(src, size*N, dst->values);
+    }
+
+    namespace shader_type
+    {
+        template<size_t N>
+        struct traits<half_vec<N>> {
+            static constexpr GLenum id = GL_HALF_FLOAT;
+            static constexpr GLint components_num = N;
+            static constexpr GLint locations_num = 1;
+            using basic_type = GLushort;
+            using name = typename traits<typename ::glcxx::detail::float_vec<N>::type>::name;
+        };
+
+        template<>
+        struct traits<int_2_10_10_10_rev> {
+            static constexpr GLenum id = GL_INT_2_10_10_10_REV;
+            static constexpr GLint components_num = 4;
+            static constexpr GLint locations_num = 1;
+            using basic_type = GLuint;
+            using name = traits<glm::vec4>::name;
+        };
+
+        template<typename T, size_t N>
+        struct traits<normalized_vec<T, N>> {
+            static constexpr GLenum id = shader_type::id<T>::value;
+            static constexpr GLint components_num = N;
+            static constexpr GLint locations_num = 1;
+            using basic_type = T;
+            using name = typename traits<typename ::glcxx::detail::float_vec<N>::type>::name;
+        };
+    }
+}
+
+#endif
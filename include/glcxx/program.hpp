@@ -23,6 +23,7 @@
 #include "glcxx/shader.hpp"
 #include "glcxx/vao_input.hpp"
 #include "glcxx/except.hpp"
+#include <bitset>
 
 namespace glcxx
 {
@@ -44,11 +45,31 @@ namespace glcxx
         void select() const
         {
             glUseProgram(_object);
+            _current = _object;
+        }
+
+        /// @brief returns true if program is currently selected
+        bool current() const
+        {
+            return _current == _object;
+        }
+
+        /// @brief returns program object id
+        GLuint id() const
+        {
+            return _object;
         }
 
     protected:
+        /// @brief links program, throws shader_linking_error on failure
+        void link() const;
+
         /// @brief program object id
         GLuint _object;
+
+        /// @brief currently selected program, tracked to select programs
+        /// lazily on draw
+        static GLuint _current;
     };
 
     class program_base : protected program_res_holder
@@ -59,8 +80,10 @@ namespace glcxx
         std::unique_ptr<shader> _geometry_shader;
 
     public:
-        /// @brief constructor
-        program_base(const std::string& glsl_version, const std::string& src, bool has_geom_shader);
+        /// @brief constructor, bind_attrib_locations is called right before
+        /// linking
+        program_base(const std::string& glsl_version, const std::string& src, bool has_geom_shader,
+                     void (*bind_attrib_locations)(GLuint));
 
         /// @brief prepends program name based #defines and declarations to src
         static std::string prepend_header_to_program(const std::string& name, const char* declarations, const std::string& src);
@@ -99,6 +122,63 @@ namespace glcxx
             static constexpr bool   value = false;
         };
 
+        /// @brief calls named set method of input, inputs with deferred
+        /// values return true if they should be flushed before next draw
+        template<typename Name, typename Input, typename T>
+        inline auto set_input(Input& input, const T& value, int)
+            -> std::enable_if_t<std::is_same<bool, decltype(input.template set<Name>(value))>::value, bool>
+        {
+            return input.template set<Name>(value);
+        }
+
+        template<typename Name, typename Input, typename T>
+        inline bool set_input(Input& input, const T& value, long)
+        {
+            input.template set<Name>(value);
+            return false;
+        }
+
+        /// @brief flushes input with deferred values
+        template<typename Input>
+        inline auto flush_input(const Input& input, int) -> decltype(input.flush())
+        {
+            input.flush();
+        }
+
+        template<typename Input>
+        inline void flush_input(const Input&, long)
+        {}
+
+        /// @brief flushes inputs marked in dirty bitset and resets it
+        template<size_t N, typename... ProgramInput>
+        inline void flush_inputs(std::bitset<N>& dirty, const ProgramInput&... input)
+        {
+            size_t index = 0;
+            glcxx_swallow(dirty[index++] ? flush_input(input, 0) : void());
+            dirty.reset();
+        }
+
+        /// @brief uniform buffer binding point of input, -1 if input isn't
+        /// uniform block
+        template<typename Input, typename = void>
+        struct uniform_binding : std::integral_constant<GLint, -1> {};
+
+        template<typename Input>
+        struct uniform_binding<Input, decltype(void(Input::uniform_binding))>
+            : std::integral_constant<GLint, GLint(Input::uniform_binding)> {};
+
+        /// @brief returns true if non negative bindings are unique
+        template<GLint... Binding>
+        constexpr bool unique_bindings()
+        {
+            constexpr GLint bindings[] = {Binding..., -1};
+            for (size_t i = 0; i < sizeof...(Binding); ++i)
+                for (size_t j = i + 1; j < sizeof...(Binding); ++j)
+                    if (bindings[i] >= 0 && bindings[i] == bindings[j])
+                        return false;
+            return true;
+        }
+
         /// @brief program impl
         template<bool HasGeomShader, typename ProgramInputTuple>
         class program_impl;
@@ -111,6 +191,10 @@ namespace glcxx
             using vao_input = typename std::tuple_element<0, std::tuple<ProgramInput...>>::type;
             static_assert(ct::specialization_of<vao_input, ::glcxx::vao_input_impl>::value, "first program input should be vao_input");
 
+            // blocks sharing binding point would read each other's buffer
+            static_assert(unique_bindings<uniform_binding<ProgramInput>::value...>(),
+                          "uniform blocks of program should have different binding points");
+
             /// @brief returns input type which has valid set<Name> method
             template<typename Name>
             using input_type = typename std::tuple_element<has_named_set_method<Name, std::tuple<ProgramInput...>>::index,
@@ -120,7 +204,32 @@ namespace glcxx
             template<typename Name>
             using set_arg_type = typename ct::function_traits<decltype(&input_type<Name>::template set<Name>)>::template arg_type<0>;
 
+            /// @brief inputs with values set after last draw, which are
+            /// flushed right before next draw, when program is selected
+            mutable std::bitset<sizeof...(ProgramInput)> _dirty;
+
+            /// @brief selects program if it is not current and flushes dirty
+            /// inputs
+            void flush() const
+            {
+                if (!current())
+                    select();
+                if (_dirty.any())
+                    flush_inputs(_dirty, static_cast<const ProgramInput&>(*this)...);
+            }
+
         public:
+            /// @brief returns true if any uniform block of program is bound to
+            /// given binding point
+            static constexpr bool has_uniform_binding(const GLint binding)
+            {
+                constexpr GLint bindings[] = {uniform_binding<ProgramInput>::value..., -1};
+                for (size_t i = 0; i < sizeof...(ProgramInput); ++i)
+                    if (bindings[i] == binding)
+                        return true;
+                return false;
+            }
+
             /// @brief ctstring containing glsl declarations of all program inputs
             using declarations = ct::string_cat<cts("\n#ifdef VERTEX\n"),
                                                 typename std::conditional<shader_type::has_decl<tag::vertex, typename ProgramInput::decl_tag>::value,
@@ -139,7 +248,8 @@ namespace glcxx
 
             /// @brief constructor
             program_impl(const std::string& name, const std::string& glsl_version, const std::string& src)
-                try : program_base(glsl_version, prepend_header_to_program(name, declarations::chars, src), HasGeomShader)
+                try : program_base(glsl_version, prepend_header_to_program(name, declarations::chars, src), HasGeomShader,
+                                   &vao_input::bind_locations)
                     , ProgramInput(_object)...
             {}
             catch(glprogram_error& e) // add usefull info to exception and rethrow
@@ -164,12 +274,62 @@ namespace glcxx
             template<typename Name>
             void set(set_arg_type<Name> value)
             {
-                input_type<Name>::template set<Name>(value);
+                if (set_input<Name>(static_cast<input_type<Name>&>(*this), value, 0))
+                    _dirty.set(has_named_set_method<Name, std::tuple<ProgramInput...>>::index);
+            }
+
+            using program_base::id;
+
+            /// @brief vao_input draw methods, program is selected if needed
+            /// and pending input values are flushed first
+            template<typename... Args>
+            void draw_elements(Args&&... args) const
+            {
+                flush();
+                vao_input::draw_elements(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args>
+            void draw_arrays(Args&&... args) const
+            {
+                flush();
+                vao_input::draw_arrays(std::forward<Args>(args)...);
             }
 
-            // bring few vao_input methods into current scope
-            using vao_input::draw_elements;
-            using vao_input::draw_arrays;
+            template<typename... Args>
+            void draw_elements_bound(Args&&... args) const
+            {
+                flush();
+                vao_input::draw_elements_bound(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args>
+            void draw_arrays_bound(Args&&... args) const
+            {
+                flush();
+                vao_input::draw_arrays_bound(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args>
+            void multi_draw_elements(Args&&... args) const
+            {
+                flush();
+                vao_input::multi_draw_elements(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args>
+            void multi_draw_arrays(Args&&... args) const
+            {
+                flush();
+                vao_input::multi_draw_arrays(std::forward<Args>(args)...);
+            }
+
+            template<typename... Args>
+            void draw_elements_indirect(Args&&... args) const
+            {
+                flush();
+                vao_input::draw_elements_indirect(std::forward<Args>(args)...);
+            }
         };
 
         /// @brief return true if program input requires geometry shader, either it
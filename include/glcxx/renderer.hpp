@@ -21,6 +21,8 @@
 #define GLCXX_RENDERER_HPP
 
 #include "glcxx/program.hpp"
+#include "glcxx/uniform_block.hpp"
+#include <initializer_list>
 
 namespace glcxx
 {
@@ -31,13 +33,42 @@ namespace glcxx
     template<typename Name>
     const char* get_program_src();
 
-    /// @brief renderer, implements program creation and program selection
-    /// @tparam std::pairs of compile time programs
+    /// @brief list of shared_uniform_blocks owned by renderer
+    template<typename... SharedBlock> struct shared_blocks;
+
+    namespace detail
+    {
+        /// @brief returns true if none of programs has uniform block bound to
+        /// any of given binding points
+        template<typename... Program>
+        constexpr bool uniform_bindings_unused(std::initializer_list<GLuint> bindings)
+        {
+            for (const GLuint binding : bindings)
+            {
+                const bool used[] = {Program::has_uniform_binding(GLint(binding))..., false};
+                for (const bool u : used)
+                    if (u)
+                        return false;
+            }
+            return true;
+        }
+    }
+
+    /// @brief renderer, implements program creation and program lookup
+    /// @tparam std::pairs of compile time programs, optionally preceded by
+    /// shared_blocks
     template<typename... NamedPrograms> class renderer;
 
-    template<typename... Name, typename... Program>
-    class renderer<std::pair<Name, Program>...>
+    template<typename... SharedBlock, typename... Name, typename... Program>
+    class renderer<shared_blocks<SharedBlock...>, std::pair<Name, Program>...>
     {
+        // shared blocks stay bound to their binding points across program
+        // switches, so program blocks can't use them
+        static_assert(detail::unique_bindings<SharedBlock::uniform_binding...>(),
+                      "shared blocks should have different binding points");
+        static_assert(detail::uniform_bindings_unused<Program...>({SharedBlock::uniform_binding...}),
+                      "program uniform block uses binding point of shared block");
+
         /// @brief disabled stuff
         renderer(const renderer&) = delete;
         renderer& operator=(const renderer& other) = delete;
@@ -46,41 +77,91 @@ namespace glcxx
         template<typename ProgramName>
         using base_name = ct::string_sub<ProgramName, 0, ct::string_find<ProgramName, cts("_")>::value>;
 
+        /// @brief ctstring containing glsl declarations of all shared blocks
+        using shared_declarations = ct::string_cat<cts(""), typename SharedBlock::declaration...>;
+
+        /// @brief connects shared blocks to their binding points in program
+        static void bind_shared_blocks(const GLuint program)
+        {
+            glcxx_swallow(SharedBlock::bind(program));
+            (void)program;
+        }
+
+        /// @brief connects shared blocks to their binding points in all
+        /// programs
+        template<size_t... I>
+        void bind_shared_blocks(std::index_sequence<I...>) const
+        {
+            glcxx_swallow(bind_shared_blocks(std::get<I>(_programs)->id()));
+        }
+
     public:
+        /// @brief number of programs
+        static constexpr size_t programs_num = sizeof...(Program);
+
         /// @brief initializes all programs of this renderer
         renderer(const std::string& glsl_version = "", const std::string& common_decl = "")
-            : _programs(std::make_unique<Program>(Name::chars, glsl_version, common_decl + get_program_src<base_name<Name>>())...)
-        {}
+            : _programs(std::make_unique<Program>(Name::chars, glsl_version,
+                                                  shared_declarations::chars + common_decl + get_program_src<base_name<Name>>())...)
+        {
+            bind_shared_blocks(std::index_sequence_for<Program...>{});
+        }
 
-        /// @brief searches given program by name in compile time, selects
-        /// requested one and returns it
+        /// @brief searches given program by name in compile time and returns
+        /// it, program is selected lazily on its next draw, so its inputs can
+        /// be set up front without switching programs
         template<typename ProgramName>
         auto& program();
 
+        /// @brief returns index of program by name, e.g. for draw_queue keys
+        template<typename ProgramName>
+        static constexpr size_t program_index()
+        {
+            constexpr size_t index = ct::tuple_find<std::tuple<Name...>, ProgramName>::value;
+            static_assert(sizeof...(Program) != index, "program name not found");
+            return index;
+        }
+
+        /// @brief searches given shared block by name in compile time and
+        /// returns it, its data is written once for all programs
+        template<typename BlockName>
+        auto& shared_block()
+        {
+            constexpr size_t index = ct::tuple_find<std::tuple<typename SharedBlock::name...>, BlockName>::value;
+            static_assert(sizeof...(SharedBlock) != index, "shared block name not found");
+            return std::get<index>(_shared_blocks);
+        }
+
     private:
+        /// @brief shared blocks, created before programs
+        std::tuple<SharedBlock...> _shared_blocks;
+
         /// @brief program list, @todo unique_ptr can be removed without providing
         /// movability or copyability to programs, when emplace style tuple
         /// constructor would be available
         std::tuple<std::unique_ptr<Program>...> _programs;
+    };
+
+    /// @brief renderer without shared blocks
+    template<typename... Name, typename... Program>
+    class renderer<std::pair<Name, Program>...> : public renderer<shared_blocks<>, std::pair<Name, Program>...>
+    {
+        /// @brief base class
+        using base = renderer<shared_blocks<>, std::pair<Name, Program>...>;
 
-        /// @brief current program index, points after last program by default
-        size_t _current_program_index = sizeof...(Program);
+    public:
+        /// @brief inherited constructor
+        using base::base;
     };
 }
 
-template<typename... Name, typename... Program>
+template<typename... SharedBlock, typename... Name, typename... Program>
 template<typename ProgramName>
-auto& glcxx::renderer<std::pair<Name, Program>...>::program()
+auto& glcxx::renderer<glcxx::shared_blocks<SharedBlock...>, std::pair<Name, Program>...>::program()
 {
     constexpr size_t index = ct::tuple_find<std::tuple<Name...>, ProgramName>::value;
     static_assert(sizeof...(Program) != index, "program name not found");
-    auto p = std::get<index>(_programs).get();
-    if (index != _current_program_index)
-    {
-        _current_program_index = index;
-        p->select();
-    }
-    return *p;
+    return *std::get<index>(_programs);
 }
 
 #endif
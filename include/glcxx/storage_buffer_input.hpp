@@ -0,0 +1,98 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_STORAGE_BUFFER_INPUT_HPP
+#define GLCXX_STORAGE_BUFFER_INPUT_HPP
+
+#include "glcxx/buffer.hpp"
+#include "glcxx/shader_type.hpp"
+
+namespace glcxx
+{
+    /// @brief base implementation for storage_buffer_input
+    class storage_buffer_input_base
+    {
+        /// @brief binding point of shader storage block
+        GLuint _binding;
+
+        /// @brief holds actual buffer
+        buffer_base_ptr _buffer;
+
+    public:
+        /// @brief constructor
+        storage_buffer_input_base(const GLuint binding)
+            : _binding(binding)
+        {}
+
+        /// @brief set new buffer as program input, buffer is bound on next
+        /// dispatch, returns true if buffer changed
+        bool set(const buffer_base_ptr& value);
+
+        /// @brief called after program was selected, binding points are
+        /// shared between programs, so buffer is bound again
+        void select() const
+        {
+            attach();
+        }
+
+        /// @brief bind buffer after it was changed, program should be
+        /// selected
+        void flush() const
+        {
+            attach();
+        }
+
+    private: // impl
+        /// @brief bind buffer to binding point
+        void attach() const;
+    };
+
+    /// @brief holds state of program's shader storage block with single
+    /// runtime sized array member, binding point is fixed in declaration
+    template<typename Name, typename ShaderType, GLuint Binding = 0, typename DeclTag = tag::all>
+    struct storage_buffer_input : public storage_buffer_input_base
+    {
+    public:
+        /// @brief name
+        using name = Name;
+
+        /// @brief declaration tag
+        using decl_tag = DeclTag;
+
+        /// @brief ctstring containing glsl declaration of storage block
+        using declaration = ct::string_cat<cts("layout(std430, binding = "), ct::string_from<size_t, Binding>,
+                                           cts(") buffer "), Name, cts("_block {\n    "),
+                                           typename shader_type::traits<ShaderType>::name, cts(" "), Name, cts("[];\n};\n")>;
+
+        /// @brief constructor
+        storage_buffer_input(const GLuint)
+            : storage_buffer_input_base(Binding)
+        {}
+
+        /// @brief named set method
+        template<typename InputName>
+        std::enable_if_t<std::is_same<InputName, Name>::value, bool>
+        set(const buffer_base_ptr& value)
+        {
+            return storage_buffer_input_base::set(value);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,165 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_STREAM_BUFFER_HPP
+#define GLCXX_STREAM_BUFFER_HPP
+
+#include "glcxx/buffer.hpp"
+#include <array>
+#include <algorithm>
+#include <cassert>
+
+namespace glcxx
+{
+    /// @brief base class for stream buffers, holds persistently mapped storage
+    /// split into partitions, while gpu reads data from one partition, client
+    /// writes next frame's data into another one, partitions are guarded by
+    /// fences so that data which is still in use is never overwritten
+    class stream_buffer_base : public buffer_base
+    {
+    public:
+        /// @brief number of partitions
+        static constexpr size_t partitions_num = 3;
+
+    private:
+        /// @brief mapped memory of whole buffer
+        char* _mapped;
+
+        /// @brief size of single partition in bytes
+        size_t _partition_size;
+
+        /// @brief current partition index
+        size_t _partition = 0;
+
+        /// @brief first free byte inside current partition
+        size_t _partition_offset = 0;
+
+        /// @brief fences of partitions, null if partition is free
+        std::array<GLsync, partitions_num> _fences{};
+
+    public:
+        /// @brief constructor, throws buffer_error if persistent mapping fails
+        stream_buffer_base(size_t partition_size, GLenum target);
+
+        /// @brief destructor
+        ~stream_buffer_base();
+
+        /// @brief reserves size bytes in current partition aligned to
+        /// alignment, returns byte offset from the beginning of the buffer,
+        /// throws buffer_error if partition has no space left, partition
+        /// size should be multiple of alignment
+        size_t allocate(size_t size, size_t alignment);
+
+        /// @brief returns pointer to mapped memory at given byte offset
+        void* mapped(size_t byte_offset) const
+        {
+            return _mapped + byte_offset;
+        }
+
+        /// @brief fences current partition and switches to next one, waits
+        /// until gpu stops reading next partition if needed, should be called
+        /// once per frame after all draw calls using current partition
+        void next_partition();
+
+        /// @brief returns number of free bytes left in current partition
+        size_t available() const
+        {
+            return _partition_size - _partition_offset;
+        }
+    };
+
+    /// @brief typesafe stream buffer, suited for data that is regenerated
+    /// every frame, data is written directly into gpu visible memory without
+    /// storage reallocation
+    template<typename Data>
+    class stream_buffer : public stream_buffer_base
+                        , public std::enable_shared_from_this<stream_buffer<Data>>
+    {
+        /// @brief alignment of every allocation
+        static constexpr size_t alignment = std::max<size_t>(alignof(Data), 4);
+
+        /// @brief partition size for given element number, rounded up to
+        /// alignment so that every partition starts aligned
+        static size_t partition_size(size_t size)
+        {
+            return (size*sizeof(Data) + 2*alignment - 1)/alignment*alignment;
+        }
+
+    public:
+        /// @brief underlying data type
+        using data = Data;
+
+        /// @brief constructor
+        /// @param size max element number which could be written per frame
+        stream_buffer(size_t size, GLenum target = GL_ARRAY_BUFFER)
+            : stream_buffer_base(partition_size(size), target)
+        {}
+
+        /// @brief reserves size elements in current partition, returned range
+        /// should be filled using pointer() before draw call that uses it,
+        /// throws buffer_error if partition has no space left
+        buffer_range<Data> allocate(size_t size)
+        {
+            const size_t byte_offset = stream_buffer_base::allocate(size*sizeof(Data), alignment);
+            return {this->shared_from_this(), GLsizei(byte_offset), GLsizei(size)};
+        }
+
+        /// @brief returns pointer to write data of given range to
+        Data* pointer(const buffer_range<Data>& range) const
+        {
+            assert(range.buffer.get() == this);
+            return static_cast<Data*>(mapped(range.byte_offset));
+        }
+
+        /// @brief copies data into current partition, returns range which
+        /// could be passed to vao::set
+        buffer_range<Data> push(const Data* data, size_t size)
+        {
+            auto range = allocate(size);
+            std::copy(data, data + size, pointer(range));
+            return range;
+        }
+
+        /// @brief copies data into current partition
+        buffer_range<Data> push(const std::vector<Data>& v)
+        {
+            return push(v.data(), v.size());
+        }
+
+        /// @brief copies data into current partition
+        template<size_t N>
+        buffer_range<Data> push(const Data (&arr)[N])
+        {
+            return push(arr, N);
+        }
+    };
+
+    /// @brief stream buffer ptr
+    template<typename Data>
+    using stream_buffer_ptr = std::shared_ptr<stream_buffer<Data>>;
+
+    /// @brief make stream buffer
+    template<typename Data>
+    inline stream_buffer_ptr<Data> make_stream_buffer(size_t size, GLenum target = GL_ARRAY_BUFFER)
+    {
+        return std::make_shared<stream_buffer<Data>>(size, target);
+    }
+}
+
+#endif
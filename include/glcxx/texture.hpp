@@ -21,7 +21,7 @@
 #define GLCXX_TEXTURE_HPP
 
 #include <memory>
-#include "glcxx/gl.hpp"
+#include "glcxx/capabilities.hpp"
 
 namespace glcxx
 {
@@ -44,6 +44,14 @@ namespace glcxx
         texture(GLenum target)
             : _target(target)
         {
+#ifdef GLCXX_USE_DSA
+            // texture object should exist before it's bound to texture unit
+            if (has_dsa())
+            {
+                glCreateTextures(_target, 1, &_id);
+                return;
+            }
+#endif
             glGenTextures(1, &_id);
         }
 
@@ -53,6 +61,18 @@ namespace glcxx
             glDeleteTextures(1, &_id);
         }
 
+        /// @brief returns texture id
+        GLuint id() const
+        {
+            return _id;
+        }
+
+        /// @brief returns texture target
+        GLenum target() const
+        {
+            return _target;
+        }
+
         /// @brief binds texture
         void bind() const
         {
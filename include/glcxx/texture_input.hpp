@@ -37,12 +37,17 @@ namespace glcxx
         /// @brief sampler id
         GLint _sampler_id;
 
+        /// @brief target of texture last bound to unit, 0 if none, so that
+        /// unit is unbound at right target after texture is reset
+        mutable GLenum _bound_target = 0;
+
     public:
         /// @brief constructor
-        texture_input_base(const GLint location, const GLint sampler_id);
+        texture_input_base(const GLuint program, const GLint location, const GLint sampler_id);
 
-        /// @brief set new texture object as program input
-        void set(const texture_ptr& value);
+        /// @brief set new texture object as program input, texture is bound
+        /// on next draw, returns true if texture changed
+        bool set(const texture_ptr& value);
 
         /// @brief called after program was selected
         void select() const
@@ -50,6 +55,10 @@ namespace glcxx
             attach();
         }
 
+        /// @brief bind texture after it was changed, program should be
+        /// selected
+        void flush() const;
+
     private: // impl
         /// @brief attach texture
         void attach() const;
@@ -71,15 +80,15 @@ namespace glcxx
 
         /// @brief constructor
         texture_input(const GLuint program)
-            : texture_input_base(get_uniform_loc(program, Name::chars), SamplerID)
+            : texture_input_base(program, get_uniform_loc(program, Name::chars), SamplerID)
         {}
 
         /// @brief named set method
         template<typename InputName>
-        std::enable_if_t<std::is_same<InputName, Name>::value>
+        std::enable_if_t<std::is_same<InputName, Name>::value, bool>
         set(const texture_ptr& value)
         {
-            texture_input_base::set(value);
+            return texture_input_base::set(value);
         }
     };
 }
@@ -21,7 +21,9 @@
 #define GLCXX_UNIFORM_HPP
 
 #include "glcxx/shader_type.hpp"
+#include "glcxx/capabilities.hpp"
 #include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 
 namespace glcxx
 {
@@ -58,11 +60,11 @@ namespace glcxx
     }                                                                   \
     template<size_t N> inline void                                      \
     attach_uniform(GLint location, const std::array<glm::tvec3<type>, N>& val) { \
-        glUniform3##suffix##v(location, glm::value_ptr(val[0]));        \
+        glUniform3##suffix##v(location, N, glm::value_ptr(val[0]));        \
     }                                                                   \
     template<size_t N> inline void                                      \
     attach_uniform(GLint location, const std::array<glm::tvec4<type>, N>& val) { \
-        glUniform4##suffix##v(location, glm::value_ptr(val[0]));        \
+        glUniform4##suffix##v(location, N, glm::value_ptr(val[0]));        \
     }
 
     /// @brief actual function definitions
@@ -72,11 +74,11 @@ namespace glcxx
 
     /// @brief overloads for matrices
     inline void attach_uniform(GLint location, const glm::mat2& val) {
-        glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(val));
+        glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(val));
     }
     template<size_t N> inline void
     attach_uniform(GLint location, const std::array<glm::mat2, N>& val) {
-        glUniformMatrix3fv(location, N, GL_FALSE, glm::value_ptr(val[0]));
+        glUniformMatrix2fv(location, N, GL_FALSE, glm::value_ptr(val[0]));
     }
     inline void attach_uniform(GLint location, const glm::mat3& val) {
         glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(val));
@@ -93,35 +95,161 @@ namespace glcxx
         glUniformMatrix4fv(location, N, GL_FALSE, glm::value_ptr(val[0]));
     }
 
+#ifdef GLCXX_USE_PROGRAM_UNIFORM
+    namespace detail
+    {
+        /// @brief glProgramUniform* counterparts of attach_uniform functions
+#define DECLARE_PROGRAM_UNIFORM_FUNCTIONS(type, suffix)                 \
+        inline void program_uniform(GLuint program, GLint location, type val) { \
+            glProgramUniform1##suffix(program, location, val);          \
+        }                                                               \
+        inline void                                                     \
+        program_uniform(GLuint program, GLint location, const glm::tvec1<type>& val) { \
+            glProgramUniform1##suffix(program, location, val.x);        \
+        }                                                               \
+        inline void                                                     \
+        program_uniform(GLuint program, GLint location, const glm::tvec2<type>& val) { \
+            glProgramUniform2##suffix(program, location, val.x, val.y); \
+        }                                                               \
+        inline void                                                     \
+        program_uniform(GLuint program, GLint location, const glm::tvec3<type>& val) { \
+            glProgramUniform3##suffix(program, location, val.x, val.y, val.z); \
+        }                                                               \
+        inline void                                                     \
+        program_uniform(GLuint program, GLint location, const glm::tvec4<type>& val) { \
+            glProgramUniform4##suffix(program, location, val.x, val.y, val.z, val.w); \
+        }                                                               \
+        template<size_t N> inline void                                  \
+        program_uniform(GLuint program, GLint location, const std::array<type, N>& val) { \
+            glProgramUniform1##suffix##v(program, location, N, glm::value_ptr(val[0])); \
+        }                                                               \
+        template<size_t N> inline void                                  \
+        program_uniform(GLuint program, GLint location, const std::array<glm::tvec2<type>, N>& val) { \
+            glProgramUniform2##suffix##v(program, location, N, glm::value_ptr(val[0])); \
+        }                                                               \
+        template<size_t N> inline void                                  \
+        program_uniform(GLuint program, GLint location, const std::array<glm::tvec3<type>, N>& val) { \
+            glProgramUniform3##suffix##v(program, location, N, glm::value_ptr(val[0])); \
+        }                                                               \
+        template<size_t N> inline void                                  \
+        program_uniform(GLuint program, GLint location, const std::array<glm::tvec4<type>, N>& val) { \
+            glProgramUniform4##suffix##v(program, location, N, glm::value_ptr(val[0])); \
+        }
+
+        /// @brief actual function definitions
+        DECLARE_PROGRAM_UNIFORM_FUNCTIONS(float, f);
+        DECLARE_PROGRAM_UNIFORM_FUNCTIONS(int, i);
+        DECLARE_PROGRAM_UNIFORM_FUNCTIONS(unsigned int, ui);
+
+        /// @brief overloads for matrices
+        inline void program_uniform(GLuint program, GLint location, const glm::mat2& val) {
+            glProgramUniformMatrix2fv(program, location, 1, GL_FALSE, glm::value_ptr(val));
+        }
+        template<size_t N> inline void
+        program_uniform(GLuint program, GLint location, const std::array<glm::mat2, N>& val) {
+            glProgramUniformMatrix2fv(program, location, N, GL_FALSE, glm::value_ptr(val[0]));
+        }
+        inline void program_uniform(GLuint program, GLint location, const glm::mat3& val) {
+            glProgramUniformMatrix3fv(program, location, 1, GL_FALSE, glm::value_ptr(val));
+        }
+        template<size_t N> inline void
+        program_uniform(GLuint program, GLint location, const std::array<glm::mat3, N>& val) {
+            glProgramUniformMatrix3fv(program, location, N, GL_FALSE, glm::value_ptr(val[0]));
+        }
+        inline void program_uniform(GLuint program, GLint location, const glm::mat4& val) {
+            glProgramUniformMatrix4fv(program, location, 1, GL_FALSE, glm::value_ptr(val));
+        }
+        template<size_t N> inline void
+        program_uniform(GLuint program, GLint location, const std::array<glm::mat4, N>& val) {
+            glProgramUniformMatrix4fv(program, location, N, GL_FALSE, glm::value_ptr(val[0]));
+        }
+    }
+#endif
+
+    /// @brief attach uniform of given program, glProgramUniform* is used if
+    /// supported, so that program doesn't have to be selected, otherwise
+    /// program should be selected
+    template<typename T>
+    inline void attach_uniform(GLuint program, GLint location, const T& val)
+    {
+#ifdef GLCXX_USE_PROGRAM_UNIFORM
+        if (has_program_uniform())
+            return detail::program_uniform(program, location, val);
+#endif
+        (void)program;
+        attach_uniform(location, val);
+    }
+
     /// @brief get uniform location
     GLint get_uniform_loc(GLuint program, const char* name);
 
+    namespace detail
+    {
+        /// @brief compares uniform values, large trivially copyable values,
+        /// e.g. matrices and arrays, are compared bytewise, which is cheaper
+        /// than memberwise comparison
+        template<typename T>
+        inline std::enable_if_t<(sizeof(T) > 16 && std::is_trivially_copyable<T>::value), bool>
+        uniform_equal(const T& a, const T& b)
+        {
+            return 0 == std::memcmp(&a, &b, sizeof(T));
+        }
+
+        template<typename T>
+        inline std::enable_if_t<!(sizeof(T) > 16 && std::is_trivially_copyable<T>::value), bool>
+        uniform_equal(const T& a, const T& b)
+        {
+            return !(a != b);
+        }
+    }
+
     /// @brief base implementation for uniform program input
     template<typename ShaderType, typename HostType>
     class uniform_base
     {
+        /// @brief program uniform belongs to
+        GLuint _program;
+
         /// @brief location of program input inside program
         GLint _location;
 
         /// @brief holds actual uniform
         HostType _uniform_data;
 
+        /// @brief true if value wasn't attached yet
+        mutable bool _dirty = false;
+
     public:
         /// @brief constructor
-        uniform_base(GLint location)
-            : _location(location)
+        uniform_base(GLuint program, GLint location)
+            : _program(program)
+            , _location(location)
         {
-            attach_uniform(_location, glsl_cast<ShaderType>(_uniform_data));
+            attach_uniform(_program, _location, glsl_cast<ShaderType>(_uniform_data));
         }
 
-        /// @brief set uniform as program input
-        void set(const HostType& value)
+        /// @brief set uniform as program input, value is attached on flush
+        /// @return true if uniform became dirty and should be flushed
+        bool set(const HostType& value)
         {
-            if (_uniform_data != value)
+            // pending value is overwritten without comparison
+            if (_dirty)
+                _uniform_data = value;
+            else if (!detail::uniform_equal(_uniform_data, value))
             {
                 _uniform_data = value;
-                attach_uniform(_location, glsl_cast<ShaderType>(_uniform_data));
+                _dirty = true;
+                return true;
             }
+            return false;
+        }
+
+        /// @brief attach pending value, program should be selected unless
+        /// glProgramUniform* is supported
+        void flush() const
+        {
+            attach_uniform(_program, _location, glsl_cast<ShaderType>(_uniform_data));
+            _dirty = false;
         }
     };
 
@@ -144,17 +272,20 @@ namespace glcxx
 
         /// @brief constructor
         uniform(const GLuint program)
-            : base(get_uniform_loc(program, Name::chars))
+            : base(program, get_uniform_loc(program, Name::chars))
         {}
 
-        /// @brief named set method
+        /// @brief named set method, value is attached on flush
+        /// @return true if uniform should be flushed
         template<typename InputName>
-        std::enable_if_t<std::is_same<InputName, Name>::value>
+        std::enable_if_t<std::is_same<InputName, Name>::value, bool>
         set(const HostType& value)
         {
-            base::set(value);
+            return base::set(value);
         }
 
+        using base::flush;
+
         /// @brief called after program was selected, nothing to do as uniforms
         /// remains attached during program selection change
         void select() const
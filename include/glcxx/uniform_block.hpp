@@ -0,0 +1,433 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_UNIFORM_BLOCK_HPP
+#define GLCXX_UNIFORM_BLOCK_HPP
+
+#include "glcxx/buffer.hpp"
+#include "glcxx/shader_type.hpp"
+#include <cstring>
+
+namespace glcxx
+{
+    /// @brief named member of uniform block
+    template<typename Name, typename ShaderType>
+    struct block_member
+    {
+        /// @brief name
+        using name = Name;
+
+        /// @brief shader type
+        using type = ShaderType;
+
+        /// @brief ctstring containing glsl declaration of member
+        using declaration = ct::string_cat<cts("    "), shader_type::name<ShaderType>, cts(" "), Name, cts(";\n")>;
+    };
+
+    namespace detail
+    {
+        /// @brief rounds size up to vec4 size, which is array and matrix
+        /// column stride of std140 layout
+        constexpr size_t std140_round(const size_t size)
+        {
+            return (size + 15)/16*16;
+        }
+
+        /// @brief std140 layout of scalars and vectors, vec3 is aligned as
+        /// vec4, but occupies 3 components only
+        template<typename ShaderType>
+        struct std140
+        {
+            using traits = shader_type::traits<ShaderType>;
+            static_assert(sizeof(typename traits::basic_type) >= 4, "std140 basic type should be 32 or 64 bit");
+
+            static constexpr size_t component_size = sizeof(typename traits::basic_type);
+            static constexpr size_t align = component_size*(3 == traits::components_num ? 4 : traits::components_num);
+            static constexpr size_t size  = component_size*traits::components_num;
+
+            static void write(unsigned char* dst, const ShaderType& value)
+            {
+                std::memcpy(dst, &value, size);
+            }
+
+            static void read(const unsigned char* src, ShaderType& value)
+            {
+                std::memcpy(&value, src, size);
+            }
+        };
+
+        /// @brief std140 layout of N elements with vec4 aligned stride, used
+        /// for arrays and matrix columns
+        template<typename Element, size_t N>
+        struct std140_array
+        {
+            static constexpr size_t stride = std140_round(std140<Element>::size);
+            static constexpr size_t align  = std140_round(std140<Element>::align);
+            static constexpr size_t size   = N*stride;
+
+            template<typename T>
+            static void write(unsigned char* dst, const T& value)
+            {
+                for (size_t i = 0; i < N; ++i)
+                    std140<Element>::write(dst + i*stride, value[i]);
+            }
+
+            template<typename T>
+            static void read(const unsigned char* src, T& value)
+            {
+                for (size_t i = 0; i < N; ++i)
+                    std140<Element>::read(src + i*stride, value[i]);
+            }
+        };
+
+        /// @brief arrays and column major matrices
+        template<typename ShaderType, size_t N>
+        struct std140<std::array<ShaderType, N>> : std140_array<ShaderType, N> {};
+        template<typename T> struct std140<glm::tmat2x2<T>> : std140_array<glm::tvec2<T>, 2> {};
+        template<typename T> struct std140<glm::tmat3x3<T>> : std140_array<glm::tvec3<T>, 3> {};
+        template<typename T> struct std140<glm::tmat4x4<T>> : std140_array<glm::tvec4<T>, 4> {};
+
+        /// @brief byte offset of member with given index, index equal to
+        /// number of members gives end of last member
+        template<typename... ShaderType>
+        constexpr size_t std140_offset(const size_t index)
+        {
+            constexpr size_t align[] = {std140<ShaderType>::align...};
+            constexpr size_t size[]  = {std140<ShaderType>::size...};
+            size_t result = 0;
+            for (size_t i = 0; i < index; ++i)
+                result = (result + align[i] - 1)/align[i]*align[i] + size[i];
+            return index < sizeof...(ShaderType) ? (result + align[index] - 1)/align[index]*align[index] : result;
+        }
+    }
+
+    /// @brief uniform block data laid out according to std140 rules, offsets
+    /// and padding are derived from member types at compile time
+    template<typename... Member>
+    class std140_struct
+    {
+        static_assert(sizeof...(Member) > 0, "uniform block should have members");
+
+        /// @return member index by name
+        template<typename MemberName>
+        struct member_index {
+            static constexpr size_t value = ct::tuple_find<std::tuple<typename Member::name...>, MemberName>::value;
+        };
+
+        /// @brief shader type of member by name
+        template<typename MemberName>
+        using member_type = typename std::tuple_element<member_index<MemberName>::value, std::tuple<typename Member::type...>>::type;
+
+    public:
+        /// @brief block size
+        static constexpr size_t size = detail::std140_round(detail::std140_offset<typename Member::type...>(sizeof...(Member)));
+
+        /// @brief ctstring containing glsl declarations of all members
+        using declaration = ct::string_cat<typename Member::declaration...>;
+
+        /// @brief returns byte offset of member
+        template<typename MemberName>
+        static constexpr size_t offset()
+        {
+            return detail::std140_offset<typename Member::type...>(member_index<MemberName>::value);
+        }
+
+        /// @brief set member value
+        template<typename MemberName, typename T>
+        void set(const T& value)
+        {
+            static_assert(member_index<MemberName>::value < sizeof...(Member), "member with given name wasn't found");
+            static_assert(is_glsl_convertible<T, member_type<MemberName>>::value, "types are not convertible");
+            detail::std140<member_type<MemberName>>::write(_data + offset<MemberName>(),
+                                                           glsl_cast<member_type<MemberName>>(value));
+        }
+
+        /// @brief get member value
+        template<typename MemberName>
+        member_type<MemberName> get() const
+        {
+            static_assert(member_index<MemberName>::value < sizeof...(Member), "member with given name wasn't found");
+            member_type<MemberName> value;
+            detail::std140<member_type<MemberName>>::read(_data + offset<MemberName>(), value);
+            return value;
+        }
+
+        /// @brief returns raw data, ready to be uploaded
+        const void* data() const
+        {
+            return _data;
+        }
+
+        /// @brief compare raw data
+        bool operator==(const std140_struct& other) const
+        {
+            return 0 == std::memcmp(_data, other._data, size);
+        }
+        bool operator!=(const std140_struct& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        /// @brief raw data, padding is zeroed
+        alignas(16) unsigned char _data[size] = {};
+    };
+
+    /// @brief ctstring containing glsl declaration of uniform block
+    template<typename Name, typename Struct>
+    using uniform_block_declaration = ct::string_cat<cts("layout(std140) uniform "), Name, cts(" {\n"),
+                                                     typename Struct::declaration, cts("};\n")>;
+
+    /// @brief get uniform block index
+    GLuint get_uniform_block_index(GLuint program, const char* name);
+
+    /// @brief base implementation for uniform_block
+    class uniform_block_base
+    {
+        /// @brief binding point of uniform block
+        GLuint _binding;
+
+        /// @brief uniform buffer, created on first upload
+        buffer_base_ptr _buffer;
+
+    public:
+        /// @brief constructor, connects block to binding point
+        uniform_block_base(GLuint program, GLuint block_index, GLuint binding);
+
+        /// @brief constructor for block not owned by program
+        explicit uniform_block_base(GLuint binding)
+            : _binding(binding)
+        {}
+
+        /// @brief upload whole block with single buffer write, buffer is
+        /// bound on flush or select
+        void upload(const void* data, size_t size);
+
+        /// @brief called after program was selected, binding points are
+        /// shared between programs, so buffer is bound again
+        void select() const
+        {
+            attach();
+        }
+
+        /// @brief bind buffer after data was changed, program should be
+        /// selected
+        void flush() const
+        {
+            attach();
+        }
+
+    private: // impl
+        /// @brief bind buffer to binding point
+        void attach() const;
+    };
+
+    /// @brief holds state of program's uniform block, Struct is
+    /// std140_struct describing block members
+    template<typename Name, typename Struct, typename DeclTag = tag::vertex, GLuint Binding = 0>
+    class uniform_block : private uniform_block_base
+    {
+        /// @brief holds actual block data
+        Struct _block_data;
+
+    public:
+        /// @brief name
+        using name = Name;
+
+        /// @brief declaration tag
+        using decl_tag = DeclTag;
+
+        /// @brief binding point, should be unique among blocks of program
+        static constexpr GLuint uniform_binding = Binding;
+
+        /// @brief ctstring containing glsl declaration of block
+        using declaration = uniform_block_declaration<Name, Struct>;
+
+        /// @brief constructor
+        uniform_block(const GLuint program)
+            : uniform_block_base(program, get_uniform_block_index(program, Name::chars), Binding)
+        {
+            upload(_block_data.data(), Struct::size);
+        }
+
+        /// @brief named set method, data is uploaded immediately, buffer is
+        /// bound on next draw, returns true if value changed
+        template<typename InputName>
+        std::enable_if_t<std::is_same<InputName, Name>::value, bool>
+        set(const Struct& value)
+        {
+            if (_block_data == value)
+                return false;
+            _block_data = value;
+            upload(_block_data.data(), Struct::size);
+            return true;
+        }
+
+        using uniform_block_base::select;
+        using uniform_block_base::flush;
+    };
+
+    /// @brief this definition is required for odr-usage
+    template<typename Name, typename Struct, typename DeclTag, GLuint Binding>
+    constexpr GLuint uniform_block<Name, Struct, DeclTag, Binding>::uniform_binding;
+
+    /// @brief base implementation for dynamic_uniform_block
+    class dynamic_uniform_block_base
+    {
+        /// @brief binding point of uniform block
+        GLuint _binding;
+
+        /// @brief buffer and byte range currently bound
+        buffer_base_ptr _buffer;
+        GLintptr _byte_offset = 0;
+        GLsizeiptr _size = 0;
+
+    public:
+        /// @brief constructor, connects block to binding point
+        dynamic_uniform_block_base(GLuint program, GLuint block_index, GLuint binding);
+
+        /// @brief set new range as block data, offset should be multiple of
+        /// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, range is bound on flush or
+        /// select, returns true if range changed
+        bool set(const buffer_base_ptr& buffer, GLintptr byte_offset, GLsizeiptr size);
+
+        /// @brief called after program was selected, binding points are
+        /// shared between programs, so range is bound again
+        void select() const
+        {
+            attach();
+        }
+
+        /// @brief bind range after it was changed, program should be selected
+        void flush() const
+        {
+            attach();
+        }
+
+    private: // impl
+        /// @brief bind range to binding point
+        void attach() const;
+    };
+
+    /// @brief holds state of program's uniform block, which data lives in
+    /// external buffer, e.g. per-draw data appended to uniform_stream, new
+    /// range is bound with glBindBufferRange on next draw
+    template<typename Name, typename Struct, typename DeclTag = tag::vertex, GLuint Binding = 0>
+    class dynamic_uniform_block : private dynamic_uniform_block_base
+    {
+        /// @brief base implementation class
+        using base = dynamic_uniform_block_base;
+
+    public:
+        /// @brief name
+        using name = Name;
+
+        /// @brief declaration tag
+        using decl_tag = DeclTag;
+
+        /// @brief binding point, should be unique among blocks of program
+        static constexpr GLuint uniform_binding = Binding;
+
+        /// @brief ctstring containing glsl declaration of block
+        using declaration = uniform_block_declaration<Name, Struct>;
+
+        /// @brief constructor
+        dynamic_uniform_block(const GLuint program)
+            : base(program, get_uniform_block_index(program, Name::chars), Binding)
+        {}
+
+        /// @brief named set method
+        template<typename InputName>
+        std::enable_if_t<std::is_same<InputName, Name>::value, bool>
+        set(const buffer_range<Struct>& value)
+        {
+            return base::set(value.buffer, value.byte_offset, Struct::size);
+        }
+
+        using base::select;
+        using base::flush;
+    };
+
+    /// @brief this definition is required for odr-usage
+    template<typename Name, typename Struct, typename DeclTag, GLuint Binding>
+    constexpr GLuint dynamic_uniform_block<Name, Struct, DeclTag, Binding>::uniform_binding;
+
+    /// @brief uniform block shared by all programs of renderer, it is
+    /// declared in each program and connected to fixed binding point in
+    /// programs which use it, so that data is written once for all programs,
+    /// @see renderer
+    template<typename Name, typename Struct, GLuint Binding>
+    class shared_uniform_block : private uniform_block_base
+    {
+        /// @brief holds actual block data
+        Struct _block_data;
+
+    public:
+        /// @brief name
+        using name = Name;
+
+        /// @brief binding point, reserved in all programs of renderer
+        static constexpr GLuint uniform_binding = Binding;
+
+        /// @brief ctstring containing glsl declaration of block
+        using declaration = uniform_block_declaration<Name, Struct>;
+
+        /// @brief constructor
+        shared_uniform_block()
+            : uniform_block_base(Binding)
+        {
+            upload(_block_data.data(), Struct::size);
+            flush();
+        }
+
+        /// @brief set block data, uploaded with single buffer write if
+        /// changed, binding point is owned by this block, so it is bound
+        /// immediately
+        void set(const Struct& value)
+        {
+            if (_block_data != value)
+            {
+                _block_data = value;
+                upload(_block_data.data(), Struct::size);
+                flush();
+            }
+        }
+
+        /// @brief returns block data
+        const Struct& get() const
+        {
+            return _block_data;
+        }
+
+        /// @brief connects block to binding point in program, unless program
+        /// doesn't use it
+        static void bind(const GLuint program)
+        {
+            const auto index = glGetUniformBlockIndex(program, Name::chars);
+            if (GL_INVALID_INDEX != index)
+                glUniformBlockBinding(program, index, Binding);
+        }
+    };
+
+    /// @brief this definition is required for odr-usage
+    template<typename Name, typename Struct, GLuint Binding>
+    constexpr GLuint shared_uniform_block<Name, Struct, Binding>::uniform_binding;
+}
+
+#endif
@@ -0,0 +1,73 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_UNIFORM_STREAM_HPP
+#define GLCXX_UNIFORM_STREAM_HPP
+
+#include "glcxx/stream_buffer.hpp"
+#include "glcxx/uniform_block.hpp"
+#include "glcxx/capabilities.hpp"
+
+namespace glcxx
+{
+    /// @brief streaming uniform buffer for per-draw uniform blocks, whole
+    /// frame's per-object data is appended into one persistently mapped
+    /// buffer, each block is aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT and
+    /// selected for draw by dynamic_uniform_block with glBindBufferRange
+    template<typename Struct>
+    class uniform_stream : public stream_buffer_base
+                         , public std::enable_shared_from_this<uniform_stream<Struct>>
+    {
+        /// @brief returns distance between consecutive blocks
+        static size_t stride()
+        {
+            const size_t alignment = uniform_buffer_offset_alignment();
+            return (Struct::size + alignment - 1)/alignment*alignment;
+        }
+
+    public:
+        /// @brief constructor
+        /// @param size max block number which could be written per frame
+        uniform_stream(size_t size)
+            : stream_buffer_base(size*stride(), GL_UNIFORM_BUFFER)
+        {}
+
+        /// @brief copies block into current partition, returns range which
+        /// could be passed to set method of dynamic_uniform_block
+        buffer_range<Struct> push(const Struct& value)
+        {
+            const size_t byte_offset = allocate(Struct::size, uniform_buffer_offset_alignment());
+            std::memcpy(mapped(byte_offset), value.data(), Struct::size);
+            return {this->shared_from_this(), GLsizei(byte_offset), 1};
+        }
+    };
+
+    /// @brief uniform stream ptr
+    template<typename Struct>
+    using uniform_stream_ptr = std::shared_ptr<uniform_stream<Struct>>;
+
+    /// @brief make uniform stream
+    template<typename Struct>
+    inline uniform_stream_ptr<Struct> make_uniform_stream(size_t size)
+    {
+        return std::make_shared<uniform_stream<Struct>>(size);
+    }
+}
+
+#endif
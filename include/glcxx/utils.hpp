@@ -254,6 +254,25 @@ namespace glcxx
         template<typename... Strings>
         using string_cat = typename string_cat_impl<Strings...>::type;
 
+        /// @brief lexicographical comparison of ct strings
+        template<typename String1, typename String2> struct string_less;
+
+        /// @brief empty string is less than any non empty one
+        template<char... str2>
+        struct string_less<string<>, string<str2...>>
+            : std::integral_constant<bool, 0 != sizeof...(str2)> {};
+
+        /// @brief nothing is less than empty string
+        template<char first1, char... rest1>
+        struct string_less<string<first1, rest1...>, string<>>
+            : std::false_type {};
+
+        /// @brief compare first chars, then the rest
+        template<char first1, char... rest1, char first2, char... rest2>
+        struct string_less<string<first1, rest1...>, string<first2, rest2...>>
+            : std::integral_constant<bool, (first1 < first2) ||
+                                     (first1 == first2 && string_less<string<rest1...>, string<rest2...>>::value)> {};
+
         /// @brief strip all occurances of given char from given ct string
         template<char c, typename String> struct string_strip_char_impl;
         template<char c, char... str>
@@ -22,7 +22,10 @@
 
 #include "glcxx/vao_base.hpp"
 #include "glcxx/attrib.hpp"
+#include "glcxx/interleave.hpp"
 #include <array>
+#include <bitset>
+#include <tuple>
 
 namespace glcxx
 {
@@ -45,6 +48,68 @@ namespace glcxx
         /// @brief instance count
         GLsizei _instance_count = -1;
 
+        /// @brief attributes which should be respecified on next bind
+        mutable std::bitset<attrib_num> _dirty;
+
+        /// @brief attributes whose vertex buffer binding should be updated on
+        /// next bind, only used with separate vertex format and binding
+        mutable std::bitset<attrib_num> _rebind;
+
+        /// @brief true if index buffer should be reattached on next bind
+        mutable bool _indices_dirty = true;
+
+        /// @brief constant values of attributes without buffer
+        std::tuple<Data...> _constants;
+
+        /// @brief attributes which use constant value
+        std::bitset<attrib_num> _constant;
+
+        /// @brief record attribute change, binding change requires only vertex
+        /// buffer rebinding if separate vertex format is supported, otherwise
+        /// attribute is respecified
+        void changed(const size_t index, const attrib::change change)
+        {
+            // buffer replaces constant value
+            _constant.reset(index);
+            if (attrib::format_changed == change ||
+                (attrib::binding_changed == change && !has_vertex_attrib_binding()))
+                _dirty.set(index);
+            else if (attrib::binding_changed == change)
+                _rebind.set(index);
+        }
+
+        /// @brief respecify dirty attributes, attributes sharing buffer are
+        /// specified together, so that each buffer is bound once
+        template<size_t... I>
+        void attach_dirty(std::index_sequence<I...>) const
+        {
+            const buffer_base* bound = nullptr;
+            while (_dirty.any())
+            {
+                size_t first = 0;
+                while (!_dirty[first])
+                    ++first;
+                const buffer_base* buf = _attribs[first].buffer().get();
+                if (buf && buf != bound && !has_vertex_attrib_binding())
+                {
+                    buf->bind();
+                    bound = buf;
+                }
+                glcxx_swallow(_dirty[I] && _attribs[I].buffer().get() == buf ?
+                              (_attribs[I].template specify<Data>(id()), _dirty.reset(I), void()) : void());
+            }
+            if (bound)
+                bound->unbind();
+        }
+
+        /// @brief apply constant values of attributes, vao should be bound
+        template<size_t... I>
+        void attach_constants(std::index_sequence<I...>) const
+        {
+            glcxx_swallow(_constant[I] && _attribs[I].location() >= 0 ?
+                          gl_vertex_attrib(_attribs[I].location(), std::get<I>(_constants)) : void());
+        }
+
         /// @return attribute index by name
         template<typename AttribName>
         struct attrib_index {
@@ -57,7 +122,8 @@ namespace glcxx
 
     public:
         using vao_base::bind;
-        using vao_base::program;
+        using vao_base::layout;
+        using vao_base::id;
 
         /// @brief get/set instance count
         auto instance_count() const { return _instance_count; }
@@ -69,7 +135,7 @@ namespace glcxx
             if (_indices != buf)
             {
                 _indices = std::move(buf);
-                program(0);
+                _indices_dirty = true;
             }
         }
 
@@ -84,8 +150,7 @@ namespace glcxx
             static_assert(index < attrib_num, "attribute with given name wasn't found");
             static_assert(is_glsl_convertible<T, attrib_shader_type<AttribName>>::value, "types are not convertible");
 
-            if (_attribs[index].set(std::move(buf), divisor, offset, normalize)) // changed?
-                program(0);
+            changed(index, _attribs[index].set(std::move(buf), divisor, offset, normalize));
         }
 
         /// @brief set attrib
@@ -100,21 +165,79 @@ namespace glcxx
             static_assert(index < attrib_num, "attribute with given name wasn't found");
             static_assert(is_glsl_convertible<U, attrib_shader_type<AttribName>>::value, "types are not convertible");
 
-            if (_attribs[index].set(std::move(buf), member, divisor, offset, normalize)) // changed?
-                program(0);
+            changed(index, _attribs[index].set(std::move(buf), member, divisor, offset, normalize));
+        }
+
+        /// @brief set attrib from buffer range, e.g. part of stream buffer
+        template<typename AttribName, typename T>
+        void set(buffer_range<T> range,
+                 const GLuint divisor = 0u,
+                 const bool normalize = true)
+        {
+            constexpr size_t index = attrib_index<AttribName>::value;
+            static_assert(index < attrib_num, "attribute with given name wasn't found");
+            static_assert(is_glsl_convertible<T, attrib_shader_type<AttribName>>::value, "types are not convertible");
+
+            changed(index, _attribs[index].set(std::move(range), divisor, normalize));
+        }
+
+        /// @brief set attrib from buffer range, e.g. part of stream buffer
+        template<typename AttribName, typename T, typename U>
+        void set(buffer_range<T> range,
+                 U T::*member,
+                 const GLuint divisor = 0u,
+                 const bool normalize = true)
+        {
+            constexpr size_t index = attrib_index<AttribName>::value;
+            static_assert(index < attrib_num, "attribute with given name wasn't found");
+            static_assert(is_glsl_convertible<U, attrib_shader_type<AttribName>>::value, "types are not convertible");
+
+            changed(index, _attribs[index].set(std::move(range), member, divisor, normalize));
+        }
+
+        /// @brief use constant value for attribute instead of per-vertex
+        /// buffer, buffer is released and attribute array gets disabled,
+        /// value is applied with glVertexAttrib* on bind
+        template<typename AttribName, typename T>
+        void set_constant(const T& value)
+        {
+            constexpr size_t index = attrib_index<AttribName>::value;
+            static_assert(index < attrib_num, "attribute with given name wasn't found");
+            static_assert(is_glsl_convertible<T, attrib_shader_type<AttribName>>::value, "types are not convertible");
+
+            changed(index, _attribs[index].clear());
+            std::get<index>(_constants) = glsl_cast<attrib_shader_type<AttribName>>(value);
+            _constant.set(index);
         }
 
         /// @brief bind index buffer if exists, otherwise unbind previously
         /// bound index buffer
         void attach_indices() const
         {
+#ifdef GLCXX_USE_DSA
+            if (has_dsa())
+            {
+                glVertexArrayElementBuffer(id(), _indices ? _indices->id() : 0);
+                return;
+            }
+#endif
             if (_indices)
                 _indices->bind();
             else
                 index_buffer::unbind();
         }
 
-        /// @brief attach vertex buffer
+        /// @brief forget all attachments before full reattachment
+        void detach() const
+        {
+            _dirty.reset();
+            _rebind.reset();
+            _indices_dirty = true;
+            for (const auto& a : _attribs)
+                a.detach();
+        }
+
+        /// @brief assign location to attribute, it is specified on next attach
         template<typename ShaderType, typename AttribName>
         void attach_attrib(const GLint location) const
         {
@@ -123,7 +246,48 @@ namespace glcxx
             static_assert(std::is_same<ShaderType, attrib_shader_type<AttribName>>::value,
                           "attrib is incompatible with provided shader type");
 
-            _attribs[index].template attach_unsafe<ShaderType>(location);
+            _attribs[index].locate(location);
+            _dirty.set(index);
+        }
+
+        /// @brief apply pending changes: reattach index buffer if it was
+        /// replaced, respecify changed attributes and rebind vertex buffers of
+        /// attributes with changed binding only, vao should be bound
+        void attach() const
+        {
+            if (_indices_dirty)
+            {
+                attach_indices();
+                _indices_dirty = false;
+            }
+#ifdef GLCXX_USE_VERTEX_ATTRIB_BINDING
+            if (_rebind.any())
+            {
+                // respecification rebinds buffers too
+                _rebind &= ~_dirty;
+                for (size_t i = 0; i < attrib_num; ++i)
+                    if (_rebind[i])
+                        _attribs[i].rebind(id());
+                _rebind.reset();
+            }
+#endif
+            if (_dirty.any())
+                attach_dirty(std::index_sequence_for<Data...>{});
+
+            // current attribute values aren't part of vao state, so they are
+            // applied on each bind
+            if (_constant.any())
+                attach_constants(std::index_sequence_for<Data...>{});
+        }
+
+        /// @brief uploads pending deferred updates of all buffers, should be
+        /// called while vao isn't bound, as index buffer binding is vao state
+        void flush() const
+        {
+            for (const auto& a : _attribs)
+                a.flush();
+            if (_indices)
+                _indices->flush();
         }
 
         /// @brief draw using index buffer
@@ -133,6 +297,24 @@ namespace glcxx
             _indices->draw(_instance_count);
         }
 
+        /// @brief draw range of index buffer, @see index_buffer::draw
+        void draw_elements(const GLuint first_index,
+                           const GLsizei count,
+                           const GLint base_vertex,
+                           const GLuint base_instance) const
+        {
+            assert(_indices);
+            _indices->draw(_instance_count, first_index, count, base_vertex, base_instance);
+        }
+
+        /// @brief draw commands from bound draw indirect buffer using index
+        /// buffer
+        void multi_draw_elements_indirect(const GLsizei draw_count, const GLintptr byte_offset = 0) const
+        {
+            assert(_indices);
+            _indices->multi_draw_indirect(draw_count, byte_offset);
+        }
+
         /// @brief upload data to attribute vbo, if doesn't exist, create it
         template<typename AttribName, typename T>
         void upload(const T* data, size_t size, GLenum usage = 0)
@@ -140,8 +322,7 @@ namespace glcxx
             constexpr size_t index = attrib_index<AttribName>::value;
             static_assert(index < attrib_num, "attribute with given name wasn't found");
             static_assert(is_glsl_convertible<T, attrib_shader_type<AttribName>>::value, "types are not convertible");
-            if (_attribs[index].upload(data, size, usage))
-                program(0);
+            changed(index, _attribs[index].upload(data, size, usage));
         }
 
         /// @brief upload data to attribute vbo, if doesn't exist, create it
@@ -162,6 +343,45 @@ namespace glcxx
             upload<AttribName>(arr.data(), N, usage);
         }
 
+        /// @brief interleave streams into single vbo and attach attributes
+        /// AttribName... to it, layout is derived from stream types at compile
+        /// time, vbo is reused if it was created by previous interleaved upload
+        /// and it's used by these attributes only, divisor and normalize flag
+        /// of every attribute are kept, streams should have same size
+        template<typename... AttribName, typename... T>
+        void upload_interleaved(GLenum usage, const std::vector<T>&... streams)
+        {
+            static_assert(sizeof...(AttribName) == sizeof...(T), "stream number doesn't match attribute number");
+            constexpr size_t index[] = {attrib_index<AttribName>::value...};
+            static_assert(!ct::tuple_contains<std::tuple<std::integral_constant<bool, (attrib_index<AttribName>::value < attrib_num)>...>,
+                                              std::false_type>::value, "attribute with given name wasn't found");
+            static_assert(!ct::tuple_contains<std::tuple<std::integral_constant<bool, is_glsl_convertible<T, attrib_shader_type<AttribName>>::value>...>,
+                                              std::false_type>::value, "types are not convertible");
+            using vertex_layout = interleaved_layout<T...>;
+
+            const auto bytes = interleave(streams...);
+            bool exclusive = _attribs[index[0]].owns_buffer(sizeof...(AttribName));
+            for (auto i : index)
+                exclusive = exclusive && _attribs[i].buffer() == _attribs[index[0]].buffer();
+            buffer_base_ptr buf = _attribs[index[0]].buffer();
+            if (exclusive)
+                buf->upload(bytes.data(), bytes.size(), usage);
+            else
+                buf = std::make_shared<buffer_base>(bytes.data(), bytes.size(), usage ? usage : GL_STATIC_DRAW, GL_ARRAY_BUFFER);
+
+            size_t i = 0;
+            glcxx_swallow(changed(index[i], _attribs[index[i]].template reset<T>(buf, vertex_layout::stride, vertex_layout::offset(i),
+                                                                                         _attribs[index[i]].divisor(),
+                                                                                         _attribs[index[i]].normalize(), true)),
+                          ++i);
+        }
+
+        /// @brief interleave streams into single vbo, @see above
+        template<typename... AttribName, typename... T>
+        void upload_interleaved(const std::vector<T>&... streams) {
+            upload_interleaved<AttribName...>(0, streams...);
+        }
+
         /// @brief upload data to index buffer, if doesn't exist, create it
         template<typename T>
         void upload_indices(const T* data, size_t size, GLenum mode, GLenum usage = 0)
@@ -169,7 +389,10 @@ namespace glcxx
             if (_indices)
                 _indices->upload(data, size, mode, usage);
             else
+            {
                 _indices = make_index_buffer(data, size, mode, usage ? usage : GL_STATIC_DRAW);
+                _indices_dirty = true;
+            }
         }
 
         /// @brief upload data to index buffer, if doesn't exist, create it
@@ -183,6 +406,27 @@ namespace glcxx
         void upload_indices(const T (&arr)[N], GLenum mode, GLenum usage = 0) {
             upload_indices(arr, N, mode, usage);
         }
+
+        /// @brief upload data to index buffer narrowing indices to smallest
+        /// fitting type, if doesn't exist, create it
+        template<typename T>
+        void upload_indices(narrow_indices_t, const T* data, size_t size, GLenum mode, GLenum usage = 0)
+        {
+            if (_indices)
+                _indices->upload(narrow_indices, data, size, mode, usage);
+            else
+            {
+                _indices = make_index_buffer(narrow_indices, data, size, mode, usage ? usage : GL_STATIC_DRAW);
+                _indices_dirty = true;
+            }
+        }
+
+        /// @brief upload data to index buffer narrowing indices to smallest
+        /// fitting type, if doesn't exist, create it
+        template<typename T>
+        void upload_indices(narrow_indices_t, const std::vector<T>& v, GLenum mode, GLenum usage = 0) {
+            upload_indices(narrow_indices, v.data(), v.size(), mode, usage);
+        }
     };
 
     /// @brief make new vao with given buffers, version for vao with index buffer
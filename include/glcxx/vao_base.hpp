@@ -25,6 +25,29 @@
 
 namespace glcxx
 {
+    /// @brief attribute location assignment of program, attributes are
+    /// identified by unique per name and type keys and get sequential
+    /// locations in lexicographical order of their names, so vao attached for
+    /// some layout serves every layout which is its prefix in that order,
+    /// regardless of declaration order in programs, but e.g. layout of "a" and
+    /// "c" isn't served by vao attached for "a", "b" and "c"
+    struct attrib_layout
+    {
+        /// @brief attribute keys in location order
+        const void* const* keys;
+
+        /// @brief number of attributes
+        size_t size;
+
+        /// @brief return true if vao attached for other layout is valid for
+        /// this one
+        bool served_by(const attrib_layout* other) const
+        {
+            return this == other ||
+                (other && size <= other->size && std::equal(keys, keys + size, other->keys));
+        }
+    };
+
     /// @brief base vao class, resource holder
     class vao_base
     {
@@ -34,24 +57,25 @@ namespace glcxx
         /// @brief vao id
         GLuint _id = 0;
 
-        /// @brief program id this vao is attached to
-        mutable GLuint _program_id = 0;
+        /// @brief attribute layout this vao is attached for, null if vao
+        /// should be reattached
+        mutable const attrib_layout* _layout = nullptr;
 
-        // only vao input is allowed to change program
+        // only vao input is allowed to change layout
         template<typename AttribInputTuple>
         friend class vao_input_impl;
 
     protected:
-        /// @brief return which program vao is currently attached to
-        GLuint program() const
+        /// @brief return which layout vao is currently attached for
+        const attrib_layout* layout() const
         {
-            return _program_id;
+            return _layout;
         }
 
-        /// @brief set program this vao is attached to
-        void program(const GLuint program_id) const
+        /// @brief set layout this vao is attached for
+        void layout(const attrib_layout* layout) const
         {
-            _program_id = program_id;
+            _layout = layout;
         }
 
     public:
@@ -64,9 +88,9 @@ namespace glcxx
         /// @brief move constructor
         vao_base(vao_base&& other) noexcept
             : _id(other._id)
-            , _program_id(other._program_id)
+            , _layout(other._layout)
         {
-            other._program_id = 0;
+            other._layout = nullptr;
             other._id = 0;
         }
 
@@ -80,10 +104,16 @@ namespace glcxx
         /// @brief assignment
         vao_base& operator=(vao_base other) noexcept {
             std::swap(_id, other._id);
-            std::swap(_program_id, other._program_id);
+            std::swap(_layout, other._layout);
             return *this;
         }
 
+        /// @brief returns vao id
+        GLuint id() const
+        {
+            return _id;
+        }
+
         /// @brief binds vao
         void bind() const
         {
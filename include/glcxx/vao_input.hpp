@@ -21,6 +21,7 @@
 #define GLCXX_VAO_INPUT_HPP
 
 #include "glcxx/vao.hpp"
+#include "glcxx/indirect_batch.hpp"
 
 namespace glcxx
 {
@@ -36,6 +37,21 @@ namespace glcxx
         using decl_tag = tag::vertex;
     };
 
+    namespace detail
+    {
+        /// @brief unique per attribute name and type key, its address
+        /// identifies attribute inside attrib_layout
+        template<typename Name, typename Type>
+        struct attrib_key
+        {
+            static constexpr char id = 0;
+        };
+
+        /// @brief this definition is required for odr-usage
+        template<typename Name, typename Type>
+        constexpr char attrib_key<Name, Type>::id;
+    }
+
     /// @brief holds state of program's vao
     template<typename AttribInputTuple> class vao_input_impl;
 
@@ -49,12 +65,54 @@ namespace glcxx
             static constexpr bool value = !ct::tuple_contains<Tuple, T>::value;
         };
 
-        /// @brief locations for all VBOs inside vao
-        std::array<GLint, sizeof...(AttribName)> _locations;
+        /// @brief attribute keys in location order, null terminated to allow
+        /// empty attribute list
+        struct key_array
+        {
+            const void* values[sizeof...(AttribName) + 1];
+        };
+        static const key_array _keys;
+
+        /// @brief layout of this input, vao attached for compatible layout is
+        /// bound without reattachment even if it was used by other program
+        static const attrib_layout _layout;
+
+        /// @brief location of attribute with given name, locations are
+        /// assigned sequentially in lexicographical order of attribute names,
+        /// so that programs declaring same attributes in different order share
+        /// layout, matrices occupy several locations
+        template<typename Name>
+        static constexpr GLint location()
+        {
+            constexpr bool before[] = {ct::string_less<AttribName, Name>::value..., false};
+            constexpr GLint locations_num[] = {shader_type::traits<Attrib>::locations_num..., 0};
+            GLint retval = 0;
+            for (size_t i = 0; i < sizeof...(AttribName); ++i)
+                retval += before[i] ? locations_num[i] : 0;
+            return retval;
+        }
+
+        /// @brief index of attribute with given name in location order
+        template<typename Name>
+        static constexpr size_t rank()
+        {
+            constexpr bool before[] = {ct::string_less<AttribName, Name>::value..., false};
+            size_t retval = 0;
+            for (size_t i = 0; i < sizeof...(AttribName); ++i)
+                retval += before[i] ? 1 : 0;
+            return retval;
+        }
 
-        /// @brief program id to check in runtime if input vao is ready to be
-        /// bound for this program or it should be reattached for this program
-        GLuint _program_id;
+        /// @brief keys sorted by attribute location
+        static constexpr key_array sorted_keys()
+        {
+            const void* const keys[] = {&detail::attrib_key<AttribName, Attrib>::id..., nullptr};
+            constexpr size_t ranks[] = {rank<AttribName>()..., 0};
+            key_array retval{};
+            for (size_t i = 0; i < sizeof...(AttribName); ++i)
+                retval.values[ranks[i]] = keys[i];
+            return retval;
+        }
 
      public:
         /// @brief vao holds VBOs, which are always vertex shader inputs
@@ -63,12 +121,19 @@ namespace glcxx
         /// @brief ctstring containing glsl declaration of attributes
         using declaration = ct::string_cat<attrib_declaration<Attrib, AttribName>...>;
 
-        /// @brief constructor
-        vao_input_impl(const GLuint program)
-            : _locations{{get_attrib_loc(program, AttribName::chars)...}}
-            , _program_id(program)
+        /// @brief constructor, locations are already bound before program
+        /// linking
+        vao_input_impl(const GLuint /*program*/)
         {}
 
+        /// @brief bind attribute locations, should be called before program
+        /// linking
+        static void bind_locations(const GLuint program)
+        {
+            glcxx_swallow(glBindAttribLocation(program, location<AttribName>(), AttribName::chars));
+            (void)program;
+        }
+
         /// @brief called after program was selected, nothing to do as vao gets
         /// passed to draw function
         void select() const
@@ -105,25 +170,155 @@ namespace glcxx
             }
         }
 
+        /// @brief draw count indices of vao's index buffer starting from
+        /// first_index, base_vertex is added to each index and base_instance
+        /// offsets instanced attributes, so that many meshes can share vertex
+        /// and index buffers of single vao
+        template<typename... T>
+        void draw_elements(const vao<T...>& vao,
+                           const GLuint first_index,
+                           const GLsizei count,
+                           const GLint base_vertex = 0,
+                           const GLuint base_instance = 0) const
+        {
+            if (0 != vao.instance_count())
+            {
+                bind(vao);
+                vao.draw_elements(first_index, count, base_vertex, base_instance);
+                vao_base::unbind();
+            }
+        }
+
+        /// @brief draw arrays with base instance offsetting instanced
+        /// attributes
+        template<typename... T>
+        void draw_arrays(const vao<T...>& vao,
+                         const GLenum mode,
+                         const GLint first,
+                         const GLsizei size,
+                         const GLuint base_instance) const
+        {
+            const auto instance_count = vao.instance_count();
+            if (0 != instance_count)
+            {
+                bind(vao);
+                glDrawArraysInstancedBaseInstance(mode, first, size, -1 == instance_count ? 1 : instance_count, base_instance);
+                vao_base::unbind();
+            }
+        }
+
+        /// @brief draw all commands of batch using index buffer from vao with
+        /// single glMultiDrawElementsIndirect call
+        template<typename... T>
+        void multi_draw_elements(const vao<T...>& vao, elements_batch& batch) const
+        {
+            if (!batch.empty())
+            {
+                bind(vao);
+                batch.bind();
+                vao.multi_draw_elements_indirect(batch.size());
+                batch.unbind();
+                vao_base::unbind();
+            }
+        }
+
+        /// @brief draw draw_count commands stored in buffer starting from
+        /// byte_offset using index buffer from vao, commands are usually
+        /// written on gpu, e.g. by gpu_culler
+        template<typename... T>
+        void draw_elements_indirect(const vao<T...>& vao,
+                                    const buffer_base_ptr& commands,
+                                    const GLsizei draw_count = 1,
+                                    const GLintptr byte_offset = 0) const
+        {
+            bind(vao);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands->id());
+            vao.multi_draw_elements_indirect(draw_count, byte_offset);
+            elements_batch::unbind();
+            vao_base::unbind();
+        }
+
+        /// @brief draw all commands of batch with single
+        /// glMultiDrawArraysIndirect call
+        template<typename... T>
+        void multi_draw_arrays(const vao<T...>& vao, const GLenum mode, arrays_batch& batch) const
+        {
+            if (!batch.empty())
+            {
+                bind(vao);
+                batch.bind();
+                glMultiDrawArraysIndirect(mode, nullptr, batch.size(), 0);
+                batch.unbind();
+                vao_base::unbind();
+            }
+        }
+
+        /// @brief draw using index buffer from vao leaving vao bound, vao is
+        /// bound only if it isn't bound already, used by draw_queue to skip
+        /// redundant binds
+        template<typename... T>
+        void draw_elements_bound(const vao<T...>& vao, const bool vao_bound) const
+        {
+            if (0 != vao.instance_count())
+            {
+                bind(vao, vao_bound);
+                vao.draw_elements();
+            }
+        }
+
+        /// @brief draw arrays leaving vao bound, @see draw_elements_bound
+        template<typename... T>
+        void draw_arrays_bound(const vao<T...>& vao,
+                               const GLenum mode,
+                               const GLint first,
+                               const GLsizei size,
+                               const bool vao_bound) const
+        {
+            const auto instance_count = vao.instance_count();
+            if (0 != instance_count)
+            {
+                bind(vao, vao_bound);
+                if (-1 == instance_count)
+                    glDrawArrays(mode, first, size);
+                else
+                    glDrawArraysInstanced(mode, first, size, instance_count);
+            }
+        }
+
      private:
-        /// @brief bind vao to current program
+        /// @brief bind vao to current program, vao_bound is true if vao is
+        /// already bound and its buffers are flushed
         template<typename... Name, typename... Data>
-        void bind(const vao<std::pair<Name, Data>...>& vao) const
+        void bind(const vao<std::pair<Name, Data>...>& vao, const bool vao_bound = false) const
         {
             using vao_tuple = std::tuple<std::pair<Name, Data>...>;
             using required_vao_tuple = std::tuple<std::pair<AttribName, Attrib>...>;
             static_assert(!ct::tuple_any_of<required_vao_tuple, doesnt_contain, vao_tuple>::value, "not all or not matching type inputs for program was provided by given vao");
 
-            vao.bind();
-            // if was attached to different program or wasn't attached at all
-            if (vao.program() != _program_id)
+            if (!vao_bound)
+            {
+                vao.flush();
+                vao.bind();
+            }
+            // if was attached for incompatible layout or wasn't attached at all
+            if (!_layout.served_by(vao.layout()))
             {
-                vao.program(_program_id);
-                vao.attach_indices();
-                glcxx_swallow(vao.template attach_attrib<Attrib, AttribName>(_locations[ct::tuple_find<std::tuple<AttribName...>, AttribName>::value]));
+                vao.layout(&_layout);
+                vao.detach();
+                glcxx_swallow(vao.template attach_attrib<Attrib, AttribName>(location<AttribName>()));
             }
+            vao.attach();
         }
     };
+
+    template<typename... AttribName, typename... Attrib>
+    const typename vao_input_impl<std::tuple<vao_input<AttribName, Attrib>...>>::key_array
+    vao_input_impl<std::tuple<vao_input<AttribName, Attrib>...>>::_keys = sorted_keys();
+
+    template<typename... AttribName, typename... Attrib>
+    const attrib_layout vao_input_impl<std::tuple<vao_input<AttribName, Attrib>...>>::_layout = {
+        _keys.values, sizeof...(AttribName)
+    };
 }
 
 #endif
@@ -18,20 +18,222 @@
 // SOFTWARE.
 
 #include "glcxx/buffer.hpp"
+#include "glcxx/buffer_pool.hpp"
+#include "glcxx/capabilities.hpp"
+#include <cstring>
+#include <algorithm>
+
+namespace
+{
+    /// @brief creates buffer name, with direct state access buffer object
+    /// itself should be created too, as it is never bound before first use
+    GLuint create_buffer()
+    {
+        GLuint id = 0;
+#ifdef GLCXX_USE_DSA
+        if (glcxx::has_dsa())
+        {
+            glCreateBuffers(1, &id);
+            return id;
+        }
+#endif
+        glGenBuffers(1, &id);
+        return id;
+    }
+}
+
+glcxx::buffer_base::buffer_base(GLenum target)
+    : _id(create_buffer())
+    , _target(target)
+    , _usage(0)
+{}
 
 glcxx::buffer_base::buffer_base(const void* data, size_t size, GLenum usage, GLenum target)
-    : _target(target)
+    : _id(0)
+    , _target(target)
     , _usage(usage)
+    , _pooled(buffer_pool::enabled())
 {
-    glGenBuffers(1, &_id);
+    if (_pooled)
+    {
+        _capacity = buffer_pool::size_class(size);
+        _id = buffer_pool::acquire(_capacity, _usage);
+    }
+    if (!_id)
+    {
+        _capacity = 0;
+        _id = create_buffer();
+    }
     upload(data, size);
 }
 
+glcxx::buffer_base::~buffer_base()
+{
+    if (_pooled && _capacity && buffer_pool::enabled())
+        buffer_pool::release(_id, _capacity, _usage);
+    else
+        glDeleteBuffers(1, &_id);
+}
+
 void glcxx::buffer_base::upload(const void* data, size_t size, GLenum usage)
 {
+    const bool usage_changed = usage && usage != _usage;
     if (usage)
         _usage = usage;
+    // whole buffer is replaced, pending updates are obsolete
+    _pending.clear();
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+    {
+        if (_pooled)
+        {
+            if (!_capacity || size > _capacity || usage_changed)
+            {
+                _capacity = buffer_pool::size_class(std::max(size, _capacity));
+                glNamedBufferData(_id, _capacity, nullptr, _usage);
+            }
+            if (data)
+                glNamedBufferSubData(_id, 0, size, data);
+        }
+        else
+            glNamedBufferData(_id, size, data, _usage);
+        return;
+    }
+#endif
+    bind();
+    if (_pooled)
+    {
+        // pooled buffer keeps its storage while data fits into it
+        if (!_capacity || size > _capacity || usage_changed)
+        {
+            _capacity = buffer_pool::size_class(std::max(size, _capacity));
+            glBufferData(_target, _capacity, nullptr, _usage);
+        }
+        if (data)
+            glBufferSubData(_target, 0, size, data);
+    }
+    else
+        glBufferData(_target, size, data, _usage);
+    unbind();
+}
+
+void glcxx::buffer_base::update(size_t byte_offset, const void* data, size_t size)
+{
+    // pending updates are uploaded later, so they should carry new bytes too
+    const size_t end = byte_offset + size;
+    for (auto& p : _pending)
+    {
+        const size_t b = std::max(byte_offset, p.begin);
+        const size_t e = std::min(end, p.begin + p.bytes.size());
+        if (b < e)
+            std::memcpy(&p.bytes[b - p.begin], static_cast<const char*>(data) + (b - byte_offset), e - b);
+    }
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+    {
+        glNamedBufferSubData(_id, byte_offset, size, data);
+        return;
+    }
+#endif
+    bind();
+    glBufferSubData(_target, byte_offset, size, data);
+    unbind();
+}
+
+void glcxx::buffer_base::update_deferred(size_t byte_offset, const void* data, size_t size)
+{
+    size_t begin = byte_offset;
+    size_t end = byte_offset + size;
+
+    // first pending update which isn't entirely to the left of new one
+    auto first = std::lower_bound(_pending.begin(), _pending.end(), begin,
+                                  [](const pending_update& p, size_t b) { return p.begin + p.bytes.size() < b; });
+    auto last = first;
+    for (; last != _pending.end() && last->begin <= end; ++last)
+    {
+        begin = std::min(begin, last->begin);
+        end   = std::max(end, last->begin + last->bytes.size());
+    }
+
+    // merge touched updates, new data is copied last as it is the latest
+    std::vector<char> bytes(end - begin);
+    for (auto p = first; p != last; ++p)
+        std::memcpy(&bytes[p->begin - begin], p->bytes.data(), p->bytes.size());
+    std::memcpy(&bytes[byte_offset - begin], data, size);
+    _pending.insert(_pending.erase(first, last), pending_update{begin, std::move(bytes)});
+}
+
+void glcxx::buffer_base::flush_pending()
+{
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+    {
+        for (const auto& p : _pending)
+            glNamedBufferSubData(_id, p.begin, p.bytes.size(), p.bytes.data());
+        _pending.clear();
+        return;
+    }
+#endif
+    bind();
+    for (const auto& p : _pending)
+        glBufferSubData(_target, p.begin, p.bytes.size(), p.bytes.data());
+    unbind();
+    _pending.clear();
+}
+
+void* glcxx::buffer_base::map(size_t byte_offset, size_t size, GLbitfield access)
+{
+    flush();
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+        return glMapNamedBufferRange(_id, byte_offset, size, access);
+#endif
+    bind();
+    void* ptr = glMapBufferRange(_target, byte_offset, size, access);
+    unbind();
+    return ptr;
+}
+
+void glcxx::buffer_base::flush_mapped(size_t byte_offset, size_t size)
+{
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+    {
+        glFlushMappedNamedBufferRange(_id, byte_offset, size);
+        return;
+    }
+#endif
+    bind();
+    glFlushMappedBufferRange(_target, byte_offset, size);
+    unbind();
+}
+
+bool glcxx::buffer_base::unmap()
+{
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+        return GL_TRUE == glUnmapNamedBuffer(_id);
+#endif
+    bind();
+    const bool retval = GL_TRUE == glUnmapBuffer(_target);
+    unbind();
+    return retval;
+}
+
+void* glcxx::buffer_base::map_persistent_storage(size_t size, GLbitfield flags)
+{
+    const GLbitfield access = flags & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT |
+                                       GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+    {
+        glNamedBufferStorage(_id, size, nullptr, flags);
+        return glMapNamedBufferRange(_id, 0, size, access);
+    }
+#endif
     bind();
-    glBufferData(_target, size, data, _usage);
+    glBufferStorage(_target, size, nullptr, flags);
+    void* ptr = glMapBufferRange(_target, 0, size, access);
     unbind();
+    return ptr;
 }
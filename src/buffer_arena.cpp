@@ -0,0 +1,111 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/buffer_arena.hpp"
+#include <algorithm>
+#include <iterator>
+
+/// @brief allocated block, as long as it is alive, arena and its buffer
+/// objects are alive too
+class glcxx::buffer_arena::allocation
+{
+    buffer_arena_ptr _arena;
+    size_t _page_index;
+    size_t _offset;
+    size_t _size;
+
+public:
+    allocation(buffer_arena_ptr arena, size_t page_index, size_t offset, size_t size)
+        : _arena(std::move(arena))
+        , _page_index(page_index)
+        , _offset(offset)
+        , _size(size)
+    {}
+
+    ~allocation()
+    {
+        _arena->free_bytes(_page_index, _offset, _size);
+    }
+};
+
+glcxx::buffer_arena::buffer_arena(size_t page_size, GLenum usage, GLenum target)
+    : _page_size(page_size)
+    , _usage(usage)
+    , _target(target)
+{}
+
+std::pair<glcxx::buffer_base_ptr, size_t> glcxx::buffer_arena::allocate_bytes(size_t size, size_t alignment)
+{
+    // first fit through all pages
+    for (size_t page_index = 0; page_index < _pages.size(); ++page_index)
+    {
+        auto& free_blocks = _pages[page_index].free_blocks;
+        for (auto it = free_blocks.begin(); it != free_blocks.end(); ++it)
+        {
+            const size_t block_offset = it->first;
+            const size_t block_end = it->first + it->second;
+            const size_t offset = (block_offset + alignment - 1)/alignment*alignment;
+            if (offset + size > block_end)
+                continue;
+
+            // split block into head and tail, which remain free
+            free_blocks.erase(it);
+            if (offset != block_offset)
+                free_blocks.emplace(block_offset, offset - block_offset);
+            if (offset + size != block_end)
+                free_blocks.emplace(offset + size, block_end - offset - size);
+
+            auto holder = std::make_shared<allocation>(shared_from_this(), page_index, offset, size);
+            return {buffer_base_ptr(std::move(holder), _pages[page_index].buffer.get()), offset};
+        }
+    }
+
+    // no room, create new page, oversized allocations get dedicated one
+    const size_t page_size = std::max(_page_size, size);
+    _pages.push_back({std::make_shared<buffer_base>(nullptr, page_size, _usage, _target), {}});
+    if (size != page_size)
+        _pages.back().free_blocks.emplace(size, page_size - size);
+    auto holder = std::make_shared<allocation>(shared_from_this(), _pages.size() - 1, 0, size);
+    return {buffer_base_ptr(std::move(holder), _pages.back().buffer.get()), 0};
+}
+
+void glcxx::buffer_arena::free_bytes(size_t page_index, size_t offset, size_t size)
+{
+    auto& free_blocks = _pages[page_index].free_blocks;
+    auto next = free_blocks.lower_bound(offset);
+
+    // coalesce with following block
+    if (next != free_blocks.end() && offset + size == next->first)
+    {
+        size += next->second;
+        next = free_blocks.erase(next);
+    }
+
+    // coalesce with preceding block
+    if (next != free_blocks.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += size;
+            return;
+        }
+    }
+    free_blocks.emplace_hint(next, offset, size);
+}
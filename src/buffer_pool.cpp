@@ -0,0 +1,156 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/buffer_pool.hpp"
+#include <deque>
+#include <map>
+#include <utility>
+
+namespace
+{
+    /// @brief parked buffer
+    struct parked_buffer
+    {
+        GLuint id;
+        size_t size_class;
+        GLenum usage;
+        GLsync fence;
+
+        /// @brief release sequence number, smaller is older
+        size_t seq;
+    };
+
+    /// @brief pool state
+    struct pool_state
+    {
+        bool enabled = false;
+        size_t max_parked_bytes = 0;
+        glcxx::buffer_pool::statistics stats;
+
+        /// @brief parked buffers by size class and usage, oldest first, usage
+        /// is a part of key as driver places storage depending on it
+        std::map<std::pair<size_t, GLenum>, std::deque<parked_buffer>> parked;
+
+        /// @brief next release sequence number
+        size_t seq = 0;
+    };
+
+    pool_state& state()
+    {
+        static pool_state s;
+        return s;
+    }
+
+    void destroy(const parked_buffer& b)
+    {
+        glDeleteSync(b.fence);
+        glDeleteBuffers(1, &b.id);
+    }
+
+    /// @brief removes oldest buffer of size class list, updates statistics
+    void unpark_front(pool_state& s, std::deque<parked_buffer>& list)
+    {
+        --s.stats.parked;
+        s.stats.parked_bytes -= list.front().size_class;
+        list.pop_front();
+    }
+}
+
+void glcxx::buffer_pool::enable(size_t max_parked_bytes)
+{
+    state().enabled = true;
+    state().max_parked_bytes = max_parked_bytes;
+}
+
+void glcxx::buffer_pool::disable()
+{
+    auto& s = state();
+    s.enabled = false;
+    for (const auto& cls : s.parked)
+        for (const auto& b : cls.second)
+            destroy(b);
+    s.parked.clear();
+    s.stats.parked = 0;
+    s.stats.parked_bytes = 0;
+}
+
+bool glcxx::buffer_pool::enabled()
+{
+    return state().enabled;
+}
+
+const glcxx::buffer_pool::statistics& glcxx::buffer_pool::stats()
+{
+    return state().stats;
+}
+
+void glcxx::buffer_pool::reset_stats()
+{
+    state().stats.hits = 0;
+    state().stats.misses = 0;
+}
+
+size_t glcxx::buffer_pool::size_class(size_t size)
+{
+    size_t retval = min_size_class;
+    while (retval < size)
+        retval <<= 1;
+    return retval;
+}
+
+GLuint glcxx::buffer_pool::acquire(size_t size_class, GLenum usage)
+{
+    auto& s = state();
+    auto cls = s.parked.find({size_class, usage});
+    if (cls != s.parked.end() && !cls->second.empty())
+    {
+        // oldest buffer is the most likely one to be released by gpu
+        auto& list = cls->second;
+        const auto status = glClientWaitSync(list.front().fence, 0, 0);
+        if (GL_ALREADY_SIGNALED == status || GL_CONDITION_SATISFIED == status)
+        {
+            const GLuint id = list.front().id;
+            glDeleteSync(list.front().fence);
+            unpark_front(s, list);
+            ++s.stats.hits;
+            return id;
+        }
+    }
+    ++s.stats.misses;
+    return 0;
+}
+
+void glcxx::buffer_pool::release(GLuint id, size_t size_class, GLenum usage)
+{
+    auto& s = state();
+    s.parked[{size_class, usage}].push_back({id, size_class, usage, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), s.seq++});
+    ++s.stats.parked;
+    s.stats.parked_bytes += size_class;
+
+    // trim oldest parked buffers, oldest buffer of each class is in front
+    while (s.stats.parked_bytes > s.max_parked_bytes)
+    {
+        std::deque<parked_buffer>* oldest = nullptr;
+        for (auto& cls : s.parked)
+            if (!cls.second.empty() && (!oldest || cls.second.front().seq < oldest->front().seq))
+                oldest = &cls.second;
+        destroy(oldest->front());
+        unpark_front(s, *oldest);
+    }
+}
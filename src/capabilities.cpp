@@ -0,0 +1,84 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/capabilities.hpp"
+
+#if defined GLCXX_USE_VERTEX_ATTRIB_BINDING || defined GLCXX_USE_PROGRAM_UNIFORM
+#include <cstring>
+
+namespace
+{
+    /// @brief returns true if context version is at least major.minor or
+    /// extension is present
+    bool supported(const GLint required_major, const GLint required_minor, const char* extension)
+    {
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > required_major || (required_major == major && minor >= required_minor))
+            return true;
+
+        GLint extensions_num = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensions_num);
+        for (GLint i = 0; i < extensions_num; ++i)
+        {
+            const auto name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && 0 == std::strcmp(name, extension))
+                return true;
+        }
+        return false;
+    }
+}
+
+#ifdef GLCXX_USE_DSA
+bool glcxx::has_dsa()
+{
+    static const bool retval = supported(4, 5, "GL_ARB_direct_state_access");
+    return retval;
+}
+#endif
+
+#ifdef GLCXX_USE_VERTEX_ATTRIB_BINDING
+bool glcxx::has_vertex_attrib_binding()
+{
+    static const bool retval = has_dsa() || supported(4, 3, "GL_ARB_vertex_attrib_binding");
+    return retval;
+}
+#endif
+
+#ifdef GLCXX_USE_PROGRAM_UNIFORM
+bool glcxx::has_program_uniform()
+{
+    static const bool retval = has_dsa() || supported(4, 1, "GL_ARB_separate_shader_objects");
+    return retval;
+}
+#endif
+#endif
+
+GLint glcxx::uniform_buffer_offset_alignment()
+{
+    static const GLint retval = []
+    {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        return alignment > 0 ? alignment : 256;
+    }();
+    return retval;
+}
@@ -0,0 +1,38 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/compute_program.hpp"
+#include "glcxx/capabilities.hpp"
+
+glcxx::compute_program_base::compute_program_base(const std::string& glsl_version, const std::string& src)
+    : program_res_holder()
+    , _compute_shader(glsl_version, src, _object, GL_COMPUTE_SHADER)
+{
+    link();
+
+    // select created program so that uniform inputs could attach default
+    // constructed values, not needed if they are attached via
+    // glProgramUniform*, inputs aren't selected yet, so program isn't marked
+    // as current
+    if (!has_program_uniform())
+    {
+        glUseProgram(_object);
+        _current = 0;
+    }
+}
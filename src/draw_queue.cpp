@@ -0,0 +1,113 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/draw_queue.hpp"
+#include <cstring>
+#include <stdexcept>
+
+uint64_t glcxx::draw_queue::make_key(size_t program_index, uint32_t texture_set, GLuint vao, float depth)
+{
+    // bit pattern of non negative float grows monotonically with its value
+    uint32_t depth_bits_pattern = 0;
+    if (depth > 0.f)
+        std::memcpy(&depth_bits_pattern, &depth, sizeof(depth));
+    const uint64_t depth_key = depth_bits_pattern >> (32 - draw_queue::depth_bits);
+
+    constexpr uint64_t texture_set_mask = (uint64_t(1) << draw_queue::texture_set_bits) - 1;
+    constexpr uint64_t vao_mask         = (uint64_t(1) << draw_queue::vao_bits) - 1;
+
+    // truncated ids would make commands of different programs or vaos
+    // interleave in sorted order
+    if (program_index >> draw_queue::program_bits)
+        throw std::out_of_range("program index doesn't fit draw queue key");
+    if (vao & ~vao_mask)
+        throw std::out_of_range("vao id doesn't fit draw queue key");
+    return uint64_t(program_index) << (64 - draw_queue::program_bits) |
+        (texture_set & texture_set_mask) << (draw_queue::vao_bits + draw_queue::depth_bits) |
+        (vao & vao_mask) << draw_queue::depth_bits |
+        depth_key;
+}
+
+void glcxx::draw_queue::sort()
+{
+    constexpr unsigned digit_bits = 8;
+    constexpr size_t buckets_num = size_t(1) << digit_bits;
+
+    _tmp.resize(_order.size());
+    for (unsigned shift = 0; shift < 64; shift += digit_bits)
+    {
+        size_t offsets[buckets_num] = {};
+        for (const auto& item : _order)
+            ++offsets[(item.key >> shift) & (buckets_num - 1)];
+
+        // skip pass if all keys share this digit
+        if (offsets[(_order.front().key >> shift) & (buckets_num - 1)] == _order.size())
+            continue;
+
+        size_t sum = 0;
+        for (auto& offset : offsets)
+        {
+            const size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+        for (const auto& item : _order)
+            _tmp[offsets[(item.key >> shift) & (buckets_num - 1)]++] = item;
+        _order.swap(_tmp);
+    }
+}
+
+void glcxx::draw_queue::submit()
+{
+    _stats = statistics();
+    if (_commands.empty())
+        return;
+
+    _order.resize(_commands.size());
+    for (size_t i = 0; i < _commands.size(); ++i)
+        _order[i] = {_commands[i].key, uint32_t(i)};
+    sort();
+
+    const draw_command* prev = nullptr;
+    bool vao_used = false;
+    for (const auto& item : _order)
+    {
+        const draw_command& cmd = _commands[item.index];
+        const size_t program_index = cmd.key >> (64 - program_bits);
+        const bool same_program = prev && prev->renderer == cmd.renderer &&
+            program_index == prev->key >> (64 - program_bits);
+        const bool setup = !same_program || prev->setup != cmd.setup || prev->user != cmd.user;
+        const bool vao_bound = prev && prev->vao == cmd.vao;
+        vao_used = vao_used || cmd.vao;
+
+        ++(same_program ? _stats.program_switches_avoided : _stats.program_switches);
+        if (cmd.vao)
+            ++(vao_bound ? _stats.vao_binds_avoided : _stats.vao_binds);
+        if (cmd.setup)
+            ++(setup ? _stats.setups : _stats.setups_avoided);
+
+        cmd.draw(cmd, setup, vao_bound);
+        prev = &cmd;
+    }
+    if (vao_used)
+        vao_base::unbind();
+
+    _stats.draws = _commands.size();
+    _commands.clear();
+}
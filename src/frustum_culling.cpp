@@ -0,0 +1,347 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/frustum_culling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#if defined __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+glcxx::frustum::frustum(const glm::mat4& m)
+{
+    // rows of matrix, glm matrices are column major
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; ++r)
+        row[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            planes[2*i][c]     = row[3][c] + row[i][c];
+            planes[2*i + 1][c] = row[3][c] - row[i][c];
+        }
+    }
+    for (auto& p : planes)
+    {
+        const float inv_length = 1.f/std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        p = glm::vec4(p.x*inv_length, p.y*inv_length, p.z*inv_length, p.w*inv_length);
+    }
+}
+
+namespace
+{
+    /// @brief writes indices of set mask bits, branchless
+    inline size_t compact(const int mask, const int lanes, const uint32_t first, uint32_t* visible)
+    {
+        size_t count = 0;
+        for (int b = 0; b < lanes; ++b)
+        {
+            visible[count] = first + b;
+            count += (mask >> b) & 1;
+        }
+        return count;
+    }
+}
+
+size_t glcxx::cull(const frustum& f, const bounding_spheres& bounds, size_t first, size_t last, uint32_t* visible)
+{
+    const float* x = bounds.x.data();
+    const float* y = bounds.y.data();
+    const float* z = bounds.z.data();
+    const float* r = bounds.radius.data();
+
+    size_t count = 0;
+    size_t i = first;
+#if defined __AVX2__
+    __m256 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        px[p] = _mm256_set1_ps(f.planes[p].x);
+        py[p] = _mm256_set1_ps(f.planes[p].y);
+        pz[p] = _mm256_set1_ps(f.planes[p].z);
+        pw[p] = _mm256_set1_ps(f.planes[p].w);
+    }
+    for (; i + 8 <= last; i += 8)
+    {
+        const __m256 vx = _mm256_loadu_ps(x + i);
+        const __m256 vy = _mm256_loadu_ps(y + i);
+        const __m256 vz = _mm256_loadu_ps(z + i);
+        const __m256 vr = _mm256_loadu_ps(r + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, px[p]), _mm256_mul_ps(vy, py[p])),
+                                           _mm256_add_ps(_mm256_mul_ps(vz, pz[p]), _mm256_add_ps(pw[p], vr)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        count += compact(_mm256_movemask_ps(inside), 8, i, visible + count);
+    }
+#elif defined __SSE2__
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        px[p] = _mm_set1_ps(f.planes[p].x);
+        py[p] = _mm_set1_ps(f.planes[p].y);
+        pz[p] = _mm_set1_ps(f.planes[p].z);
+        pw[p] = _mm_set1_ps(f.planes[p].w);
+    }
+    for (; i + 4 <= last; i += 4)
+    {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+        const __m128 vr = _mm_loadu_ps(r + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, px[p]), _mm_mul_ps(vy, py[p])),
+                                        _mm_add_ps(_mm_mul_ps(vz, pz[p]), _mm_add_ps(pw[p], vr)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+        }
+        count += compact(_mm_movemask_ps(inside), 4, i, visible + count);
+    }
+#endif
+    for (; i < last; ++i)
+    {
+        bool inside = true;
+        for (const auto& p : f.planes)
+            inside = inside && (x[i]*p.x + y[i]*p.y) + (z[i]*p.z + (p.w + r[i])) >= 0.f;
+        visible[count] = i;
+        count += inside;
+    }
+    return count;
+}
+
+size_t glcxx::cull(const frustum& f, const bounding_boxes& bounds, size_t first, size_t last, uint32_t* visible)
+{
+    // for each plane only box corner which is farthest along plane normal is
+    // tested, it's selected by normal component signs which are same for all
+    // boxes
+    const float* cx[6];
+    const float* cy[6];
+    const float* cz[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        cx[p] = f.planes[p].x >= 0.f ? bounds.max_x.data() : bounds.min_x.data();
+        cy[p] = f.planes[p].y >= 0.f ? bounds.max_y.data() : bounds.min_y.data();
+        cz[p] = f.planes[p].z >= 0.f ? bounds.max_z.data() : bounds.min_z.data();
+    }
+
+    size_t count = 0;
+    size_t i = first;
+#if defined __AVX2__
+    __m256 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        px[p] = _mm256_set1_ps(f.planes[p].x);
+        py[p] = _mm256_set1_ps(f.planes[p].y);
+        pz[p] = _mm256_set1_ps(f.planes[p].z);
+        pw[p] = _mm256_set1_ps(f.planes[p].w);
+    }
+    for (; i + 8 <= last; i += 8)
+    {
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(cx[p] + i), px[p]),
+                                                         _mm256_mul_ps(_mm256_loadu_ps(cy[p] + i), py[p])),
+                                           _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(cz[p] + i), pz[p]), pw[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        count += compact(_mm256_movemask_ps(inside), 8, i, visible + count);
+    }
+#elif defined __SSE2__
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        px[p] = _mm_set1_ps(f.planes[p].x);
+        py[p] = _mm_set1_ps(f.planes[p].y);
+        pz[p] = _mm_set1_ps(f.planes[p].z);
+        pw[p] = _mm_set1_ps(f.planes[p].w);
+    }
+    for (; i + 4 <= last; i += 4)
+    {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cx[p] + i), px[p]),
+                                                   _mm_mul_ps(_mm_loadu_ps(cy[p] + i), py[p])),
+                                        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cz[p] + i), pz[p]), pw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+        }
+        count += compact(_mm_movemask_ps(inside), 4, i, visible + count);
+    }
+#endif
+    for (; i < last; ++i)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6; ++p)
+        {
+            const auto& pl = f.planes[p];
+            inside = inside && (cx[p][i]*pl.x + cy[p][i]*pl.y) + (cz[p][i]*pl.z + pl.w) >= 0.f;
+        }
+        visible[count] = i;
+        count += inside;
+    }
+    return count;
+}
+
+/// @brief threads waiting for chunks of next cull, chunk 0 is processed by
+/// calling thread, chunk t by worker t
+struct glcxx::frustum_culler::worker_pool
+{
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable start;
+    std::condition_variable done;
+
+    /// @brief current job, called with chunk index
+    void (*job)(void* context, size_t chunk) = nullptr;
+    void* context = nullptr;
+    size_t chunks_num = 0;
+
+    /// @brief incremented for every job, workers which haven't finished
+    /// current job yet
+    size_t generation = 0;
+    size_t pending = 0;
+    bool stop = false;
+
+    explicit worker_pool(size_t workers_num)
+    {
+        threads.reserve(workers_num);
+        for (size_t t = 1; t <= workers_num; ++t)
+            threads.emplace_back([this, t] { run(t); });
+    }
+
+    ~worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        start.notify_all();
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    void run(const size_t index)
+    {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;)
+        {
+            start.wait(lock, [&] { return stop || generation != seen; });
+            if (stop)
+                return;
+            seen = generation;
+            lock.unlock();
+            if (index < chunks_num)
+                job(context, index);
+            lock.lock();
+            if (0 == --pending)
+                done.notify_one();
+        }
+    }
+
+    /// @brief runs job over chunks and waits for all of them
+    void execute(void (*func)(void*, size_t), void* ctx, size_t num)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = func;
+            context = ctx;
+            chunks_num = num;
+            pending = threads.size();
+            ++generation;
+        }
+        start.notify_all();
+        func(ctx, 0);
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return 0 == pending; });
+    }
+};
+
+glcxx::frustum_culler::frustum_culler(size_t threads_num)
+    : _threads_num(threads_num ? threads_num : std::max(1u, std::thread::hardware_concurrency()))
+{}
+
+glcxx::frustum_culler::~frustum_culler() = default;
+glcxx::frustum_culler::frustum_culler(frustum_culler&&) noexcept = default;
+glcxx::frustum_culler& glcxx::frustum_culler::operator=(frustum_culler&&) noexcept = default;
+
+size_t glcxx::frustum_culler::cull(const frustum& f, const bounding_spheres& bounds)
+{
+    return cull_parallel(f, bounds);
+}
+
+size_t glcxx::frustum_culler::cull(const frustum& f, const bounding_boxes& bounds)
+{
+    return cull_parallel(f, bounds);
+}
+
+template<typename Bounds>
+size_t glcxx::frustum_culler::cull_parallel(const frustum& f, const Bounds& bounds)
+{
+    const size_t size = bounds.size();
+    if (_visible.size() < size)
+        _visible.resize(size);
+
+    const size_t threads_num = std::max<size_t>(1, std::min(_threads_num, size/min_bounds_per_thread));
+    if (1 == threads_num)
+        return glcxx::cull(f, bounds, 0, size, _visible.data());
+
+    // every chunk writes its output at its own beginning, output is then
+    // compacted, chunk is 8 aligned to keep simd loads aligned to lane count
+    struct job
+    {
+        const frustum& f;
+        const Bounds& bounds;
+        size_t size;
+        size_t chunk;
+        uint32_t* visible;
+        size_t* counts;
+    };
+    _counts.resize(threads_num);
+    job ctx{f, bounds, size, ((size + threads_num - 1)/threads_num + 7)/8*8, _visible.data(), _counts.data()};
+    if (!_pool)
+        _pool = std::make_unique<worker_pool>(_threads_num - 1);
+    _pool->execute([](void* context, size_t t)
+    {
+        const job& j = *static_cast<const job*>(context);
+        const size_t first = std::min(t*j.chunk, j.size);
+        j.counts[t] = glcxx::cull(j.f, j.bounds, first, std::min(first + j.chunk, j.size), j.visible + first);
+    }, &ctx, threads_num);
+
+    size_t count = _counts[0];
+    for (size_t t = 1; t < threads_num; ++t)
+    {
+        std::memmove(_visible.data() + count, _visible.data() + std::min(t*ctx.chunk, size), _counts[t]*sizeof(uint32_t));
+        count += _counts[t];
+    }
+    return count;
+}
@@ -0,0 +1,181 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/indices.hpp"
+#include "glcxx/buffer.hpp"
+#include <algorithm>
+#include <vector>
+
+#if defined __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+GLuint glcxx::max_index(const GLuint* data, size_t size)
+{
+    GLuint retval = 0;
+    size_t i = 0;
+#if defined __AVX2__
+    __m256i max8 = _mm256_setzero_si256();
+    for (; i + 8 <= size; i += 8)
+        max8 = _mm256_max_epu32(max8, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    alignas(32) GLuint lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), max8);
+    retval = *std::max_element(lanes, lanes + 8);
+#elif defined __SSE2__
+    // there is no unsigned 32 bit max in SSE2, flip sign bit and use signed
+    // comparison instead
+    const __m128i sign = _mm_set1_epi32(0x80000000);
+    __m128i max4 = sign;
+    for (; i + 4 <= size; i += 4)
+    {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), sign);
+        const __m128i gt = _mm_cmpgt_epi32(v, max4);
+        max4 = _mm_or_si128(_mm_and_si128(gt, v), _mm_andnot_si128(gt, max4));
+    }
+    alignas(16) GLuint lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(max4, sign));
+    retval = *std::max_element(lanes, lanes + 4);
+#endif
+    for (; i < size; ++i)
+        retval = std::max(retval, data[i]);
+    return retval;
+}
+
+GLuint glcxx::max_index(const GLushort* data, size_t size)
+{
+    GLushort retval = 0;
+    size_t i = 0;
+#if defined __AVX2__
+    __m256i max16 = _mm256_setzero_si256();
+    for (; i + 16 <= size; i += 16)
+        max16 = _mm256_max_epu16(max16, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    alignas(32) GLushort lanes[16];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), max16);
+    retval = *std::max_element(lanes, lanes + 16);
+#elif defined __SSE2__
+    // flip sign bit to use signed 16 bit max
+    const __m128i sign = _mm_set1_epi16(short(0x8000));
+    __m128i max8 = sign;
+    for (; i + 8 <= size; i += 8)
+        max8 = _mm_max_epi16(max8, _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), sign));
+    alignas(16) GLushort lanes[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_xor_si128(max8, sign));
+    retval = *std::max_element(lanes, lanes + 8);
+#endif
+    for (; i < size; ++i)
+        retval = std::max(retval, data[i]);
+    return retval;
+}
+
+GLuint glcxx::max_index(const GLubyte* data, size_t size)
+{
+    return size ? *std::max_element(data, data + size) : 0;
+}
+
+void glcxx::convert_indices(const GLuint* src, size_t size, GLushort* dst)
+{
+    size_t i = 0;
+#if defined __AVX2__
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8));
+        // pack works within 128 bit lanes, restore order afterwards
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+    }
+#elif defined __SSE2__
+    // there is no unsigned saturation pack in SSE2, shift values into signed
+    // range, pack with signed saturation and shift back
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(short(0x8000));
+    for (; i + 8 <= size; i += 8)
+    {
+        const __m128i a = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), bias32);
+        const __m128i b = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)), bias32);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(_mm_packs_epi32(a, b), bias16));
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLushort(src[i]);
+}
+
+void glcxx::convert_indices(const GLuint* src, size_t size, GLubyte* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    // values fit into byte, so signed saturation never kicks in
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+        const __m128i lo = _mm_packs_epi32(_mm_loadu_si128(s),     _mm_loadu_si128(s + 1));
+        const __m128i hi = _mm_packs_epi32(_mm_loadu_si128(s + 2), _mm_loadu_si128(s + 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLubyte(src[i]);
+}
+
+void glcxx::convert_indices(const GLushort* src, size_t size, GLubyte* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_mm_loadu_si128(s), _mm_loadu_si128(s + 1)));
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLubyte(src[i]);
+}
+
+namespace
+{
+    /// @brief narrows indices to U and uploads them
+    template<typename U, typename T>
+    void upload_as(glcxx::index_buffer& buf, const T* data, size_t size, GLenum mode, GLenum usage)
+    {
+        std::vector<U> narrowed(size);
+        glcxx::convert_indices(data, size, narrowed.data());
+        buf.upload(narrowed, mode, usage);
+    }
+}
+
+void glcxx::index_buffer::upload_narrowed(const GLuint* data, size_t size, GLenum mode, GLenum usage)
+{
+    const GLuint max = max_index(data, size);
+    if (max <= 0xff)
+        upload_as<GLubyte>(*this, data, size, mode, usage);
+    else if (max <= 0xffff)
+        upload_as<GLushort>(*this, data, size, mode, usage);
+    else
+        upload(data, size, mode, usage);
+}
+
+void glcxx::index_buffer::upload_narrowed(const GLushort* data, size_t size, GLenum mode, GLenum usage)
+{
+    if (max_index(data, size) <= 0xff)
+        upload_as<GLubyte>(*this, data, size, mode, usage);
+    else
+        upload(data, size, mode, usage);
+}
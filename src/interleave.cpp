@@ -0,0 +1,82 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/interleave.hpp"
+#include <cstring>
+
+#if defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    /// @brief strided copy of fixed size elements
+    template<size_t Size>
+    void scatter(char* dst, size_t stride, const char* src, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i, dst += stride, src += Size)
+            std::memcpy(dst, src, Size);
+    }
+
+#if defined __SSE2__
+    template<>
+    void scatter<8>(char* dst, size_t stride, const char* src, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i, dst += stride, src += 8)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+    }
+
+    template<>
+    void scatter<12>(char* dst, size_t stride, const char* src, size_t count)
+    {
+        // 8 + 4 bytes, as 16 byte load would read past the last element
+        for (size_t i = 0; i < count; ++i, dst += stride, src += 12)
+        {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+            std::memcpy(dst + 8, src + 8, 4);
+        }
+    }
+
+    template<>
+    void scatter<16>(char* dst, size_t stride, const char* src, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i, dst += stride, src += 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    }
+#endif
+}
+
+void glcxx::interleave(void* dst, size_t stride, size_t count, const interleave_stream* streams, size_t streams_num)
+{
+    for (size_t s = 0; s < streams_num; ++s)
+    {
+        char* d = static_cast<char*>(dst) + streams[s].offset;
+        const char* src = static_cast<const char*>(streams[s].src);
+        switch (streams[s].size)
+        {
+            case 4:  scatter<4>(d, stride, src, count); break;
+            case 8:  scatter<8>(d, stride, src, count); break;
+            case 12: scatter<12>(d, stride, src, count); break;
+            case 16: scatter<16>(d, stride, src, count); break;
+            default:
+                for (size_t i = 0; i < count; ++i)
+                    std::memcpy(d + i*stride, src + i*streams[s].size, streams[s].size);
+        }
+    }
+}
@@ -0,0 +1,330 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/mesh_optimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+    /// @brief fifo cache simulation, returns for every triangle number of
+    /// cache misses it caused
+    template<typename T>
+    std::vector<unsigned> simulate_fifo(const T* indices, size_t size, size_t vertex_num, size_t cache_size)
+    {
+        // timestamp based fifo, vertex is in cache if it was inserted less
+        // than cache_size insertions ago
+        std::vector<size_t> inserted(vertex_num, 0);
+        size_t time = cache_size + 1;
+        std::vector<unsigned> misses(size/3, 0);
+        for (size_t i = 0; i < size; ++i)
+        {
+            const T v = indices[i];
+            if (time - inserted[v] > cache_size)
+            {
+                inserted[v] = time++;
+                ++misses[i/3];
+            }
+        }
+        return misses;
+    }
+
+    /// @brief Forsyth's vertex scoring
+    class forsyth_score
+    {
+        static constexpr size_t max_valence = 32;
+        static constexpr float last_tri_score = 0.75f;
+        static constexpr float cache_decay_power = 1.5f;
+        static constexpr float valence_boost_scale = 2.f;
+        static constexpr float valence_boost_power = 0.5f;
+
+        std::vector<float> _cache_scores;
+        float _valence_scores[max_valence + 1];
+
+    public:
+        explicit forsyth_score(size_t cache_size)
+            : _cache_scores(cache_size)
+        {
+            for (size_t i = 0; i < cache_size; ++i)
+                _cache_scores[i] = i < 3 ? last_tri_score
+                    : std::pow(1.f - float(i - 3)/(cache_size - 3), cache_decay_power);
+            _valence_scores[0] = 0.f;
+            for (size_t i = 1; i <= max_valence; ++i)
+                _valence_scores[i] = valence_boost_scale*std::pow(float(i), -valence_boost_power);
+        }
+
+        /// @param cache_pos position in lru cache, -1 if not in cache
+        float operator()(int cache_pos, size_t remaining_valence) const
+        {
+            if (0 == remaining_valence)
+                return -1.f;
+            const float cache = (cache_pos < 0 || size_t(cache_pos) >= _cache_scores.size()) ? 0.f : _cache_scores[cache_pos];
+            return cache + _valence_scores[std::min(remaining_valence, max_valence)];
+        }
+    };
+
+    // std::min takes arguments by reference, so definition is required
+    constexpr size_t forsyth_score::max_valence;
+}
+
+template<typename T>
+glcxx::vertex_cache_statistics glcxx::analyze_vertex_cache(const std::vector<T>& indices, size_t vertex_num, size_t cache_size)
+{
+    vertex_cache_statistics retval;
+    const auto misses = simulate_fifo(indices.data(), indices.size(), vertex_num, cache_size);
+    retval.vertices_transformed = std::accumulate(misses.begin(), misses.end(), size_t(0));
+    if (!misses.empty())
+        retval.acmr = float(retval.vertices_transformed)/misses.size();
+    if (vertex_num)
+        retval.atvr = float(retval.vertices_transformed)/vertex_num;
+    return retval;
+}
+
+template<typename T>
+void glcxx::optimize_vertex_cache(std::vector<T>& indices, size_t vertex_num, size_t cache_size)
+{
+    const size_t tri_num = indices.size()/3;
+    if (tri_num < 2 || cache_size < 4)
+        return;
+
+    const forsyth_score score(cache_size);
+
+    // per vertex adjacency, triangles not emitted yet are kept in front of
+    // each vertex's list
+    std::vector<size_t> valence(vertex_num, 0);
+    for (size_t i = 0; i < tri_num*3; ++i)
+        ++valence[indices[i]];
+    std::vector<size_t> adjacency_offset(vertex_num + 1, 0);
+    std::partial_sum(valence.begin(), valence.end(), adjacency_offset.begin() + 1);
+    std::vector<size_t> adjacency(tri_num*3);
+    {
+        std::vector<size_t> fill(adjacency_offset.begin(), adjacency_offset.end() - 1);
+        for (size_t i = 0; i < tri_num*3; ++i)
+            adjacency[fill[indices[i]]++] = i/3;
+    }
+
+    std::vector<int> cache_pos(vertex_num, -1);
+    std::vector<float> vertex_score(vertex_num);
+    for (size_t v = 0; v < vertex_num; ++v)
+        vertex_score[v] = score(-1, valence[v]);
+
+    std::vector<float> tri_score(tri_num);
+    std::vector<bool> emitted(tri_num, false);
+    for (size_t t = 0; t < tri_num; ++t)
+        tri_score[t] = vertex_score[indices[3*t]] + vertex_score[indices[3*t + 1]] + vertex_score[indices[3*t + 2]];
+
+    // lru cache, 3 extra slots for vertices pushed out by new triangle
+    std::vector<size_t> cache, new_cache;
+    cache.reserve(cache_size + 3);
+    new_cache.reserve(cache_size + 3);
+
+    std::vector<T> result;
+    result.reserve(tri_num*3);
+
+    size_t best = std::max_element(tri_score.begin(), tri_score.end()) - tri_score.begin();
+    size_t scan_from = 0;
+    for (size_t emitted_num = 0; emitted_num < tri_num; ++emitted_num)
+    {
+        if (tri_num == best)
+        {
+            // no candidates in cache, pick best of remaining triangles
+            float best_score = -1.f;
+            for (size_t t = scan_from; t < tri_num; ++t)
+            {
+                if (emitted[t])
+                {
+                    if (t == scan_from)
+                        ++scan_from;
+                    continue;
+                }
+                if (tri_score[t] > best_score)
+                {
+                    best_score = tri_score[t];
+                    best = t;
+                }
+            }
+        }
+
+        emitted[best] = true;
+        new_cache.clear();
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const size_t v = indices[3*best + k];
+            result.push_back(T(v));
+
+            // remove emitted triangle from vertex adjacency
+            auto first = adjacency.begin() + adjacency_offset[v];
+            auto last = first + valence[v];
+            std::iter_swap(std::find(first, last, best), last - 1);
+            --valence[v];
+            new_cache.push_back(v);
+        }
+        for (auto v : cache)
+            if (v != new_cache[0] && v != new_cache[1] && v != new_cache[2])
+                new_cache.push_back(v);
+
+        // update scores of vertices in cache and vertices pushed out of it
+        for (auto v : cache)
+            cache_pos[v] = -1;
+        for (size_t i = 0; i < new_cache.size(); ++i)
+        {
+            const size_t v = new_cache[i];
+            cache_pos[v] = i < cache_size ? int(i) : -1;
+            vertex_score[v] = score(cache_pos[v], valence[v]);
+        }
+
+        // rescore triangles touching updated vertices, choose next best
+        best = tri_num;
+        float best_score = -1.f;
+        for (auto v : new_cache)
+        {
+            for (size_t a = adjacency_offset[v], e = a + valence[v]; a < e; ++a)
+            {
+                const size_t t = adjacency[a];
+                tri_score[t] = vertex_score[indices[3*t]] + vertex_score[indices[3*t + 1]] + vertex_score[indices[3*t + 2]];
+                if (tri_score[t] > best_score)
+                {
+                    best_score = tri_score[t];
+                    best = t;
+                }
+            }
+        }
+
+        if (new_cache.size() > cache_size)
+            new_cache.resize(cache_size);
+        std::swap(cache, new_cache);
+    }
+
+    // keep trailing indices of incomplete triangle, if any
+    result.insert(result.end(), indices.begin() + tri_num*3, indices.end());
+    indices.swap(result);
+}
+
+template<typename T>
+void glcxx::optimize_overdraw(std::vector<T>& indices, const std::vector<glm::vec3>& positions,
+                              float threshold, size_t cache_size)
+{
+    const size_t tri_num = indices.size()/3;
+    if (tri_num < 2)
+        return;
+
+    // split into clusters at points where vertex cache gets effectively
+    // flushed, so that reordering clusters doesn't hurt cache efficiency much
+    const auto misses = simulate_fifo(indices.data(), tri_num*3, positions.size(), cache_size);
+    const float mesh_acmr = float(std::accumulate(misses.begin(), misses.end(), size_t(0)))/tri_num;
+    std::vector<size_t> clusters{0};
+    size_t cluster_misses = 0;
+
+    // cluster misses are simulated with cache flushed at cluster start, as
+    // reordered cluster is drawn after unrelated one, timestamp based fifo
+    // is flushed by advancing time
+    std::vector<size_t> inserted(positions.size(), 0);
+    size_t time = cache_size + 1;
+    for (size_t t = 0; t < tri_num; ++t)
+    {
+        const size_t cluster_size = t - clusters.back();
+        // hard boundary, triangle doesn't share vertices with cache, or soft
+        // boundary, cluster drawn alone is nearly as cache efficient as mesh
+        if (cluster_size > 0 &&
+            (3 == misses[t] || float(cluster_misses)/cluster_size <= mesh_acmr*threshold))
+        {
+            clusters.push_back(t);
+            cluster_misses = 0;
+            time += cache_size + 1;
+        }
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const T v = indices[3*t + k];
+            if (time - inserted[v] > cache_size)
+            {
+                inserted[v] = time++;
+                ++cluster_misses;
+            }
+        }
+    }
+    clusters.push_back(tri_num);
+
+    // mesh centroid
+    glm::vec3 mesh_center(0.f);
+    for (size_t i = 0; i < tri_num*3; ++i)
+        mesh_center += positions[indices[i]];
+    mesh_center /= float(tri_num*3);
+
+    // sort clusters by how much they face outwards
+    const size_t cluster_num = clusters.size() - 1;
+    std::vector<float> sort_key(cluster_num);
+    for (size_t c = 0; c < cluster_num; ++c)
+    {
+        glm::vec3 center(0.f), normal(0.f);
+        float area = 0.f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const glm::vec3& p0 = positions[indices[3*t]];
+            const glm::vec3& p1 = positions[indices[3*t + 1]];
+            const glm::vec3& p2 = positions[indices[3*t + 2]];
+            const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            const float a = glm::length(n);
+            center += (p0 + p1 + p2)*(a/3.f);
+            normal += n;
+            area += a;
+        }
+        if (area > 0.f)
+            center /= area;
+        const float normal_length = glm::length(normal);
+        sort_key[c] = normal_length > 0.f ? glm::dot(center - mesh_center, normal/normal_length) : 0.f;
+    }
+
+    std::vector<size_t> order(cluster_num);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&sort_key](size_t a, size_t b) { return sort_key[a] > sort_key[b]; });
+
+    std::vector<T> result;
+    result.reserve(indices.size());
+    for (auto c : order)
+        result.insert(result.end(), indices.begin() + 3*clusters[c], indices.begin() + 3*clusters[c + 1]);
+    result.insert(result.end(), indices.begin() + tri_num*3, indices.end());
+    indices.swap(result);
+}
+
+template<typename T>
+std::vector<GLuint> glcxx::optimize_vertex_fetch(std::vector<T>& indices, size_t vertex_num)
+{
+    std::vector<GLuint> remap(vertex_num, ~0u);
+    GLuint next = 0;
+    for (auto& i : indices)
+    {
+        if (~0u == remap[i])
+            remap[i] = next++;
+        i = T(remap[i]);
+    }
+    return remap;
+}
+
+/// explicit instantiations for supported index types
+#define GLCXX_INSTANTIATE_MESH_OPTIMIZER(T)                                       \
+    template glcxx::vertex_cache_statistics                                       \
+    glcxx::analyze_vertex_cache(const std::vector<T>&, size_t, size_t);           \
+    template void glcxx::optimize_vertex_cache(std::vector<T>&, size_t, size_t);  \
+    template void glcxx::optimize_overdraw(std::vector<T>&, const std::vector<glm::vec3>&, float, size_t); \
+    template std::vector<GLuint> glcxx::optimize_vertex_fetch(std::vector<T>&, size_t)
+
+GLCXX_INSTANTIATE_MESH_OPTIMIZER(GLubyte);
+GLCXX_INSTANTIATE_MESH_OPTIMIZER(GLushort);
+GLCXX_INSTANTIATE_MESH_OPTIMIZER(GLuint);
@@ -0,0 +1,221 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/packed_types.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined __F16C__ || defined __AVX2__
+#include <immintrin.h>
+#elif defined __SSE2__
+#include <emmintrin.h>
+#endif
+
+GLushort glcxx::float_to_half(float f)
+{
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    const GLushort sign = (x >> 16) & 0x8000;
+    uint32_t abs = x & 0x7fffffff;
+
+    // inf or nan
+    if (abs >= 0x7f800000)
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+
+    // too large, rounds to inf
+    if (abs >= 0x477ff000)
+        return sign | 0x7c00;
+
+    // denormalized half, scale so that rounding to integer gives mantissa
+    if (abs < 0x38800000)
+    {
+        float a;
+        std::memcpy(&a, &abs, sizeof(a));
+        return sign | GLushort(std::nearbyint(a*16777216.f));
+    }
+
+    // rebias exponent, round mantissa to nearest even
+    abs += 0xc8000fff + ((abs >> 13) & 1);
+    return sign | GLushort(abs >> 13);
+}
+
+float glcxx::half_to_float(GLushort h)
+{
+    const uint32_t sign = uint32_t(h & 0x8000) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1f;
+    const uint32_t mantissa = h & 0x3ff;
+    if (0 == exponent)
+        return sign ? -std::ldexp(float(mantissa), -24) : std::ldexp(float(mantissa), -24);
+
+    const uint32_t x = sign | (31 == exponent ? 0x7f800000 | (mantissa << 13)
+                                              : ((exponent + 112) << 23) | (mantissa << 13));
+    float f;
+    std::memcpy(&f, &x, sizeof(f));
+    return f;
+}
+
+namespace
+{
+    /// @brief combines already scaled and rounded components
+    inline GLuint pack_2_10_10_10(GLint x, GLint y, GLint z, GLint w)
+    {
+        return (GLuint(x) & 0x3ff) | (GLuint(y) & 0x3ff) << 10 | (GLuint(z) & 0x3ff) << 20 | (GLuint(w) & 0x3) << 30;
+    }
+
+    /// @brief scales and rounds single snorm component
+    inline GLint snorm(float v, float max)
+    {
+        return GLint(std::nearbyint(std::min(std::max(v, -1.f), 1.f)*max));
+    }
+
+    /// @brief scales and rounds single unorm component
+    inline GLint unorm(float v, float max)
+    {
+        return GLint(std::nearbyint(std::min(std::max(v, 0.f), 1.f)*max));
+    }
+
+#if defined __SSE2__
+    /// @brief loads 4 floats, clamps them to [lo,1] and scales to integers
+    inline __m128i scale4(const float* src, __m128 lo, __m128 max)
+    {
+        const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), lo), _mm_set1_ps(1.f));
+        return _mm_cvtps_epi32(_mm_mul_ps(v, max));
+    }
+#endif
+}
+
+glcxx::int_2_10_10_10_rev::operator glm::vec4() const
+{
+    // sign extend every component
+    const GLint x = GLint(bits << 22) >> 22;
+    const GLint y = GLint(bits << 12) >> 22;
+    const GLint z = GLint(bits << 2) >> 22;
+    const GLint w = GLint(bits) >> 30;
+    return glm::vec4(std::max(x/511.f, -1.f), std::max(y/511.f, -1.f), std::max(z/511.f, -1.f), std::max(float(w), -1.f));
+}
+
+glcxx::int_2_10_10_10_rev::operator glm::vec3() const
+{
+    const glm::vec4 v = static_cast<glm::vec4>(*this);
+    return glm::vec3(v.x, v.y, v.z);
+}
+
+void glcxx::pack_half(const float* src, size_t size, GLushort* dst)
+{
+    size_t i = 0;
+#if defined __F16C__
+    for (; i + 4 <= size; i += 4)
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+    for (; i < size; ++i)
+        dst[i] = float_to_half(src[i]);
+}
+
+void glcxx::pack_int_2_10_10_10_rev(const glm::vec4* src, size_t size, int_2_10_10_10_rev* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    const __m128 lo = _mm_set1_ps(-1.f);
+    const __m128 max = _mm_setr_ps(511.f, 511.f, 511.f, 1.f);
+    for (; i < size; ++i)
+    {
+        alignas(16) GLint c[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(c), scale4(&src[i].x, lo, max));
+        dst[i].bits = pack_2_10_10_10(c[0], c[1], c[2], c[3]);
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i].bits = pack_2_10_10_10(snorm(src[i].x, 511.f), snorm(src[i].y, 511.f),
+                                      snorm(src[i].z, 511.f), snorm(src[i].w, 1.f));
+}
+
+void glcxx::pack_int_2_10_10_10_rev(const glm::vec3* src, size_t size, int_2_10_10_10_rev* dst)
+{
+    for (size_t i = 0; i < size; ++i)
+        dst[i].bits = pack_2_10_10_10(snorm(src[i].x, 511.f), snorm(src[i].y, 511.f), snorm(src[i].z, 511.f), 0);
+}
+
+void glcxx::pack_normalized(const float* src, size_t size, GLbyte* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    const __m128 lo = _mm_set1_ps(-1.f);
+    const __m128 max = _mm_set1_ps(127.f);
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i a = _mm_packs_epi32(scale4(src + i,     lo, max), scale4(src + i + 4,  lo, max));
+        const __m128i b = _mm_packs_epi32(scale4(src + i + 8, lo, max), scale4(src + i + 12, lo, max));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi16(a, b));
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLbyte(snorm(src[i], 127.f));
+}
+
+void glcxx::pack_normalized(const float* src, size_t size, GLubyte* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    const __m128 lo = _mm_setzero_ps();
+    const __m128 max = _mm_set1_ps(255.f);
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i a = _mm_packs_epi32(scale4(src + i,     lo, max), scale4(src + i + 4,  lo, max));
+        const __m128i b = _mm_packs_epi32(scale4(src + i + 8, lo, max), scale4(src + i + 12, lo, max));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLubyte(unorm(src[i], 255.f));
+}
+
+void glcxx::pack_normalized(const float* src, size_t size, GLshort* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    const __m128 lo = _mm_set1_ps(-1.f);
+    const __m128 max = _mm_set1_ps(32767.f);
+    for (; i + 8 <= size; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_packs_epi32(scale4(src + i, lo, max), scale4(src + i + 4, lo, max)));
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLshort(snorm(src[i], 32767.f));
+}
+
+void glcxx::pack_normalized(const float* src, size_t size, GLushort* dst)
+{
+    size_t i = 0;
+#if defined __SSE2__
+    // no unsigned saturation pack in SSE2, shift into signed range and back
+    const __m128 lo = _mm_setzero_ps();
+    const __m128 max = _mm_set1_ps(65535.f);
+    const __m128i bias32 = _mm_set1_epi32(0x8000);
+    const __m128i bias16 = _mm_set1_epi16(short(0x8000));
+    for (; i + 8 <= size; i += 8)
+    {
+        const __m128i a = _mm_sub_epi32(scale4(src + i,     lo, max), bias32);
+        const __m128i b = _mm_sub_epi32(scale4(src + i + 4, lo, max), bias32);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(_mm_packs_epi32(a, b), bias16));
+    }
+#endif
+    for (; i < size; ++i)
+        dst[i] = GLushort(unorm(src[i], 65535.f));
+}
@@ -21,6 +21,9 @@
 
 #include <algorithm>
 #include "glcxx/except.hpp"
+#include "glcxx/capabilities.hpp"
+
+GLuint glcxx::program_res_holder::_current = 0;
 
 glcxx::program_res_holder::program_res_holder()
     : _object(glCreateProgram())
@@ -28,9 +31,30 @@ glcxx::program_res_holder::program_res_holder()
 
 glcxx::program_res_holder::~program_res_holder()
 {
+    if (current())
+        _current = 0;
     glDeleteProgram(_object);
 }
 
+void glcxx::program_res_holder::link() const
+{
+    glLinkProgram(_object);
+    GLint linked;
+    glGetProgramiv(_object, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        GLint log_length = 0;
+        glGetProgramiv(_object, GL_INFO_LOG_LENGTH, &log_length);
+        auto error_msg = std::make_unique<GLchar[]>(log_length);
+        if (log_length > 0)
+        {
+            GLsizei len = 0;
+            glGetProgramInfoLog(_object, log_length, &len, error_msg.get());
+        }
+        throw shader_linking_error(std::string("program linking failed:\n") + error_msg.get());
+    }
+}
+
 std::string glcxx::program_base::prepend_header_to_program(const std::string& name, const char* declarations, const std::string& src)
 {
     std::string result;
@@ -46,29 +70,23 @@ std::string glcxx::program_base::prepend_header_to_program(const std::string& na
     return result;
 }
 
-glcxx::program_base::program_base(const std::string& glsl_version, const std::string& src, bool has_geom_shader)
+glcxx::program_base::program_base(const std::string& glsl_version, const std::string& src, bool has_geom_shader,
+                                  void (*bind_attrib_locations)(GLuint))
     : program_res_holder()
     , _vertex_shader(glsl_version, src, _object, GL_VERTEX_SHADER)
     , _fragment_shader(glsl_version, src, _object, GL_FRAGMENT_SHADER)
     , _geometry_shader(has_geom_shader ? std::make_unique<shader>(glsl_version, src, _object, GL_GEOMETRY_SHADER) : nullptr)
 {
-    glLinkProgram(_object);
-    GLint linked;
-    glGetProgramiv(_object, GL_LINK_STATUS, &linked);
-    if (!linked)
-    {
-        GLint log_length = 0;
-        glGetProgramiv(_object, GL_INFO_LOG_LENGTH, &log_length);
-        auto error_msg = std::make_unique<GLchar[]>(log_length);
-        if (log_length > 0)
-        {
-            GLsizei len = 0;
-            glGetProgramInfoLog(_object, log_length, &len, error_msg.get());
-        }
-        throw shader_linking_error(std::string("program linking failed:\n") + error_msg.get());
-    }
+    bind_attrib_locations(_object);
+    link();
 
     // select created program so that uniform inputs could attach default
-    // constructed values
-    select();
+    // constructed values, not needed if they are attached via
+    // glProgramUniform*, inputs aren't selected yet, so program isn't marked
+    // as current
+    if (!has_program_uniform())
+    {
+        glUseProgram(_object);
+        _current = 0;
+    }
 }
@@ -35,7 +35,8 @@ namespace
     const char* shader_type_to_str(const GLenum shader_type)
     {
         return GL_VERTEX_SHADER == shader_type ? "VERTEX" :
-            GL_GEOMETRY_SHADER  == shader_type ? "GEOMETRY" : "FRAGMENT";
+            GL_GEOMETRY_SHADER  == shader_type ? "GEOMETRY" :
+            GL_COMPUTE_SHADER   == shader_type ? "COMPUTE" : "FRAGMENT";
     }
 }
 
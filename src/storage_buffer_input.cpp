@@ -0,0 +1,40 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/storage_buffer_input.hpp"
+
+bool glcxx::storage_buffer_input_base::set(const buffer_base_ptr& value)
+{
+    if (_buffer == value)
+        return false;
+    _buffer = value;
+    return true;
+}
+
+void glcxx::storage_buffer_input_base::attach() const
+{
+    if (_buffer)
+    {
+        // shader may read data uploaded with deferred updates
+        _buffer->flush();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _binding, _buffer->id());
+    }
+    else
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, _binding, 0);
+}
@@ -0,0 +1,68 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/stream_buffer.hpp"
+#include "glcxx/except.hpp"
+
+glcxx::stream_buffer_base::stream_buffer_base(size_t partition_size, GLenum target)
+    : buffer_base(target)
+    , _mapped(static_cast<char*>(map_persistent_storage(partitions_num*partition_size,
+                                                        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)))
+    , _partition_size(partition_size)
+{
+    // e.g. buffer storage isn't supported, partition is empty or out of
+    // memory, writes through null mapping would crash far from the cause
+    if (!_mapped)
+        throw buffer_error("stream buffer mapping failed");
+}
+
+glcxx::stream_buffer_base::~stream_buffer_base()
+{
+    for (auto fence : _fences)
+        if (fence)
+            glDeleteSync(fence);
+    unmap();
+}
+
+size_t glcxx::stream_buffer_base::allocate(size_t size, size_t alignment)
+{
+    const size_t offset = (_partition_offset + alignment - 1)/alignment*alignment;
+    // writing past partition end would overwrite data gpu may still read
+    if (offset + size > _partition_size)
+        throw buffer_error("stream buffer partition overflow");
+    _partition_offset = offset + size;
+    return _partition*_partition_size + offset;
+}
+
+void glcxx::stream_buffer_base::next_partition()
+{
+    _fences[_partition] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _partition = (_partition + 1) % partitions_num;
+    _partition_offset = 0;
+
+    if (auto& fence = _fences[_partition])
+    {
+        // flush commands on first wait only, then just wait for gpu
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while (GL_TIMEOUT_EXPIRED == glClientWaitSync(fence, flags, 1000000))
+            flags = 0;
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
@@ -19,33 +19,60 @@
 
 #include "glcxx/texture_input.hpp"
 #include "glcxx/uniform.hpp"
+#include "glcxx/capabilities.hpp"
 
-glcxx::texture_input_base::texture_input_base(const GLint location, const GLint sampler_id)
+glcxx::texture_input_base::texture_input_base(const GLuint program, const GLint location, const GLint sampler_id)
     : _location(location)
     , _sampler_id(sampler_id)
 {
-    attach_uniform(_location, _sampler_id);
+    attach_uniform(program, _location, _sampler_id);
 }
 
-void glcxx::texture_input_base::set(const texture_ptr& value)
+bool glcxx::texture_input_base::set(const texture_ptr& value)
 {
-    if (_texture != value)
+    if (_texture == value)
+        return false;
+    _texture = value;
+    return true;
+}
+
+void glcxx::texture_input_base::flush() const
+{
+    if (_texture)
     {
-        if (_texture)
-        {
-            glActiveTexture(GL_TEXTURE0 + _sampler_id);
-            _texture->unbind();
-        }
-        _texture = value;
+        // binding to unit replaces previous texture, no unbind required
         attach();
+        return;
     }
+    if (!_bound_target)
+        return;
+
+    // unbind target previous texture was bound to, e.g. cube map
+    const GLenum target = _bound_target;
+    _bound_target = 0;
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
+    {
+        glBindTextureUnit(_sampler_id, 0);
+        return;
+    }
+#endif
+    glActiveTexture(GL_TEXTURE0 + _sampler_id);
+    glBindTexture(target, 0);
 }
 
 void glcxx::texture_input_base::attach() const
 {
-    if (_texture)
+    if (!_texture)
+        return;
+    _bound_target = _texture->target();
+#ifdef GLCXX_USE_DSA
+    if (has_dsa())
     {
-        glActiveTexture(GL_TEXTURE0 + _sampler_id);
-        _texture->bind();
+        glBindTextureUnit(_sampler_id, _texture->id());
+        return;
     }
+#endif
+    glActiveTexture(GL_TEXTURE0 + _sampler_id);
+    _texture->bind();
 }
@@ -0,0 +1,70 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/uniform_block.hpp"
+#include "glcxx/except.hpp"
+
+GLuint glcxx::get_uniform_block_index(GLuint program, const char* name)
+{
+    const auto index = glGetUniformBlockIndex(program, name);
+    if (GL_INVALID_INDEX == index)
+        throw input_location_error(std::string("uniform block ") + name + " index wasn't found");
+    return index;
+}
+
+glcxx::uniform_block_base::uniform_block_base(GLuint program, GLuint block_index, GLuint binding)
+    : _binding(binding)
+{
+    glUniformBlockBinding(program, block_index, _binding);
+}
+
+void glcxx::uniform_block_base::upload(const void* data, size_t size)
+{
+    if (_buffer)
+        _buffer->update(0, data, size);
+    else
+        _buffer = std::make_shared<buffer_base>(data, size, GL_DYNAMIC_DRAW, GL_UNIFORM_BUFFER);
+}
+
+void glcxx::uniform_block_base::attach() const
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, _binding, _buffer->id());
+}
+
+glcxx::dynamic_uniform_block_base::dynamic_uniform_block_base(GLuint program, GLuint block_index, GLuint binding)
+    : _binding(binding)
+{
+    glUniformBlockBinding(program, block_index, _binding);
+}
+
+bool glcxx::dynamic_uniform_block_base::set(const buffer_base_ptr& buffer, GLintptr byte_offset, GLsizeiptr size)
+{
+    if (_buffer == buffer && _byte_offset == byte_offset && _size == size)
+        return false;
+    _buffer = buffer;
+    _byte_offset = byte_offset;
+    _size = size;
+    return true;
+}
+
+void glcxx::dynamic_uniform_block_base::attach() const
+{
+    if (_buffer)
+        glBindBufferRange(GL_UNIFORM_BUFFER, _binding, _buffer->id(), _byte_offset, _size);
+}
@@ -0,0 +1,57 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef GLCXX_TESTS_CHECK_HPP
+#define GLCXX_TESTS_CHECK_HPP
+
+#include <cstdio>
+
+namespace glcxx_test
+{
+    /// @brief number of failed checks
+    inline int& failures()
+    {
+        static int retval = 0;
+        return retval;
+    }
+
+    /// @brief report failed check
+    inline bool check(bool cond, const char* expr, const char* file, int line)
+    {
+        if (!cond)
+        {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+            ++failures();
+        }
+        return cond;
+    }
+
+    /// @brief test exit code
+    inline int result()
+    {
+        if (failures())
+            std::fprintf(stderr, "%d check(s) failed\n", failures());
+        return failures() ? 1 : 0;
+    }
+}
+
+/// @brief checks condition, reports failure and continues
+#define GLCXX_CHECK(cond) glcxx_test::check((cond), #cond, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,146 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/draw_queue.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    /// @brief keys and recording indices of executed commands
+    std::vector<std::pair<uint64_t, GLint>> executed;
+
+    /// @brief number of setup calls
+    size_t setups = 0;
+
+    void draw(const glcxx::draw_command& cmd, const bool setup, bool /*vao_bound*/)
+    {
+        if (setup && cmd.setup)
+            cmd.setup(cmd.user);
+        executed.emplace_back(cmd.key, cmd.first);
+    }
+
+    void setup(const void*)
+    {
+        ++setups;
+    }
+
+    /// @brief command without vao, recording index is stored in first
+    glcxx::draw_command command(uint64_t key, GLint index, void (*setup_func)(const void*) = nullptr)
+    {
+        static int renderer;
+        return {key, &draw, &renderer, nullptr, setup_func, nullptr, 0, index, 0};
+    }
+
+    void test_make_key(std::mt19937& rng)
+    {
+        using glcxx::draw_queue;
+
+        // fields are ordered from program to depth
+        GLCXX_CHECK(draw_queue::make_key(1, 0, 0, 0.f) > draw_queue::make_key(0, 0xffff, 0xffff, 1e30f));
+        GLCXX_CHECK(draw_queue::make_key(0, 1, 0, 0.f) > draw_queue::make_key(0, 0, 0xffff, 1e30f));
+        GLCXX_CHECK(draw_queue::make_key(0, 0, 1, 0.f) > draw_queue::make_key(0, 0, 0, 1e30f));
+
+        // negative depth is clamped to zero
+        GLCXX_CHECK(draw_queue::make_key(0, 0, 0, -1.f) == draw_queue::make_key(0, 0, 0, 0.f));
+
+        // depth order is kept up to its precision
+        std::uniform_real_distribution<float> dist(0.f, 1000.f);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const float a = dist(rng), b = dist(rng);
+            GLCXX_CHECK(a > b || draw_queue::make_key(0, 0, 0, a) <= draw_queue::make_key(0, 0, 0, b));
+        }
+
+        // ids which don't fit are rejected
+        bool thrown = false;
+        try { draw_queue::make_key(0, 0, 1 << draw_queue::vao_bits, 0.f); }
+        catch (const std::out_of_range&) { thrown = true; }
+        GLCXX_CHECK(thrown);
+
+        thrown = false;
+        try { draw_queue::make_key(1 << draw_queue::program_bits, 0, 0, 0.f); }
+        catch (const std::out_of_range&) { thrown = true; }
+        GLCXX_CHECK(thrown);
+    }
+
+    /// @brief submitted commands are executed in stable key order
+    void test_sort(std::mt19937& rng)
+    {
+        glcxx::draw_queue queue;
+        for (size_t size : {0, 1, 2, 17, 256, 1000})
+        {
+            // few distinct values per field give many equal keys
+            std::uniform_int_distribution<uint64_t> field(0, 3);
+            for (GLint i = 0; i < GLint(size); ++i)
+            {
+                const uint64_t key = field(rng) << 56 | field(rng) << 40 | field(rng) << 24 | field(rng) << 3 | field(rng);
+                queue.record(command(key, i));
+            }
+            GLCXX_CHECK(size == queue.size());
+
+            executed.clear();
+            queue.submit();
+            GLCXX_CHECK(size == executed.size());
+            GLCXX_CHECK(std::is_sorted(executed.begin(), executed.end()));
+            GLCXX_CHECK(size == queue.stats().draws);
+            GLCXX_CHECK(0 == queue.size());
+        }
+
+        // keys with all bits of single byte set exercise every radix digit
+        std::uniform_int_distribution<int> byte(0, 7);
+        for (GLint i = 0; i < 500; ++i)
+            queue.record(command(uint64_t(0xff) << 8*byte(rng), i));
+        executed.clear();
+        queue.submit();
+        GLCXX_CHECK(std::is_sorted(executed.begin(), executed.end()));
+    }
+
+    /// @brief program switches and setup calls are skipped for consecutive
+    /// commands of same program and setup
+    void test_stats()
+    {
+        using glcxx::draw_queue;
+        glcxx::draw_queue queue;
+        setups = 0;
+        for (GLint i = 0; i < 12; ++i)
+            queue.record(command(draw_queue::make_key(size_t(i%3), 0, 0, float(i)), i, &setup));
+        queue.submit();
+
+        const auto& stats = queue.stats();
+        GLCXX_CHECK(12 == stats.draws);
+        GLCXX_CHECK(3 == stats.program_switches);
+        GLCXX_CHECK(9 == stats.program_switches_avoided);
+        GLCXX_CHECK(3 == stats.setups && 3 == setups);
+        GLCXX_CHECK(9 == stats.setups_avoided);
+        GLCXX_CHECK(0 == stats.vao_binds && 0 == stats.vao_binds_avoided);
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    test_make_key(rng);
+    test_sort(rng);
+    test_stats();
+    return glcxx_test::result();
+}
@@ -0,0 +1,169 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/frustum_culling.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// @brief distance from plane under which reference result is considered
+    /// ambiguous, as kernels may round differently
+    constexpr double epsilon = 1e-4;
+
+    /// @brief perspective frustum looking along -z
+    glcxx::frustum make_frustum()
+    {
+        const float n = 1.f, f = 100.f, t = 1.f/std::tan(0.6f);
+        glm::mat4 m;
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                m[c][r] = 0.f;
+        m[0][0] = t/1.5f;
+        m[1][1] = t;
+        m[2][2] = (f + n)/(n - f);
+        m[2][3] = -1.f;
+        m[3][2] = 2.f*f*n/(n - f);
+        return glcxx::frustum(m);
+    }
+
+    /// @brief min signed distance over planes of nearest bounds point
+    double distance(const glcxx::frustum& f, double x, double y, double z, double r)
+    {
+        double retval = 1e30;
+        for (const auto& p : f.planes)
+            retval = std::min(retval, x*p.x + y*p.y + z*p.z + p.w + r);
+        return retval;
+    }
+
+    double distance(const glcxx::frustum& f, const glcxx::bounding_spheres& b, size_t i)
+    {
+        return distance(f, b.x[i], b.y[i], b.z[i], b.radius[i]);
+    }
+
+    double distance(const glcxx::frustum& f, const glcxx::bounding_boxes& b, size_t i)
+    {
+        double retval = 1e30;
+        for (const auto& p : f.planes)
+            retval = std::min(retval, (p.x >= 0.f ? b.max_x[i] : b.min_x[i])*double(p.x) +
+                                      (p.y >= 0.f ? b.max_y[i] : b.min_y[i])*double(p.y) +
+                                      (p.z >= 0.f ? b.max_z[i] : b.min_z[i])*double(p.z) + p.w);
+        return retval;
+    }
+
+    glcxx::bounding_spheres random_spheres(std::mt19937& rng, size_t size)
+    {
+        std::uniform_real_distribution<float> xy(-80.f, 80.f), z(-120.f, 10.f), r(0.f, 5.f);
+        glcxx::bounding_spheres retval;
+        for (size_t i = 0; i < size; ++i)
+            retval.push(glm::vec3(xy(rng), xy(rng), z(rng)), r(rng));
+        return retval;
+    }
+
+    glcxx::bounding_boxes random_boxes(std::mt19937& rng, size_t size)
+    {
+        std::uniform_real_distribution<float> xy(-80.f, 80.f), z(-120.f, 10.f), extent(0.f, 5.f);
+        glcxx::bounding_boxes retval;
+        for (size_t i = 0; i < size; ++i)
+        {
+            const glm::vec3 min(xy(rng), xy(rng), z(rng));
+            retval.push(min, glm::vec3(min.x + extent(rng), min.y + extent(rng), min.z + extent(rng)));
+        }
+        return retval;
+    }
+
+    /// @brief checks that visible indices are ascending, lie in [first,last)
+    /// and match scalar reference except ambiguous bounds
+    template<typename Bounds>
+    void check_visible(const glcxx::frustum& f, const Bounds& bounds, size_t first, size_t last,
+                       const uint32_t* visible, size_t count)
+    {
+        GLCXX_CHECK(std::is_sorted(visible, visible + count));
+        GLCXX_CHECK(0 == count || (first <= visible[0] && visible[count - 1] < last));
+        size_t v = 0;
+        for (size_t i = first; i < last; ++i)
+        {
+            const bool reported = v < count && visible[v] == i;
+            v += reported;
+            const double d = distance(f, bounds, i);
+            if (std::abs(d) >= epsilon)
+                GLCXX_CHECK(reported == (d > 0.));
+        }
+        GLCXX_CHECK(v == count);
+    }
+
+    /// @brief simd kernels with scalar tails against scalar reference over
+    /// ranges of every alignment
+    template<typename Bounds>
+    void test_kernel(const glcxx::frustum& f, const Bounds& bounds)
+    {
+        std::vector<uint32_t> visible(bounds.size());
+        for (size_t first = 0; first < 9; ++first)
+        {
+            for (size_t last : {first, first + 1, first + 7, first + 8, first + 33, bounds.size()})
+            {
+                last = std::min(last, bounds.size());
+                const size_t count = glcxx::cull(f, bounds, first, last, visible.data());
+                check_visible(f, bounds, first, last, visible.data(), count);
+            }
+        }
+    }
+
+    /// @brief parallel culler gives same result as single kernel call, also
+    /// when it's reused with different sizes
+    template<typename Bounds>
+    void test_culler(const glcxx::frustum& f, const Bounds& bounds)
+    {
+        std::vector<uint32_t> expected(bounds.size());
+        const size_t expected_count = glcxx::cull(f, bounds, 0, bounds.size(), expected.data());
+        check_visible(f, bounds, 0, bounds.size(), expected.data(), expected_count);
+
+        glcxx::frustum_culler single(1), parallel(4);
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            GLCXX_CHECK(expected_count == single.cull(f, bounds));
+            GLCXX_CHECK(std::equal(expected.begin(), expected.begin() + expected_count, single.visible()));
+            GLCXX_CHECK(expected_count == parallel.cull(f, bounds));
+            GLCXX_CHECK(std::equal(expected.begin(), expected.begin() + expected_count, parallel.visible()));
+        }
+
+        // move keeps worker pool usable
+        glcxx::frustum_culler moved(std::move(parallel));
+        GLCXX_CHECK(expected_count == moved.cull(f, bounds));
+        GLCXX_CHECK(std::equal(expected.begin(), expected.begin() + expected_count, moved.visible()));
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    const glcxx::frustum f = make_frustum();
+
+    test_kernel(f, random_spheres(rng, 1000));
+    test_kernel(f, random_boxes(rng, 1000));
+
+    // large enough to be split across all threads
+    const size_t size = 5*glcxx::frustum_culler::min_bounds_per_thread + 3;
+    test_culler(f, random_spheres(rng, size));
+    test_culler(f, random_boxes(rng, size));
+    return glcxx_test::result();
+}
@@ -0,0 +1,87 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/indices.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// @brief random indices of given type, some of them have highest bit
+    /// set, as simd kernels emulate unsigned comparison by flipping it
+    template<typename T>
+    std::vector<T> random_indices(std::mt19937& rng, size_t size, T max)
+    {
+        std::uniform_int_distribution<unsigned long long> dist(0, max);
+        std::vector<T> retval(size);
+        for (auto& i : retval)
+            i = T(dist(rng));
+        return retval;
+    }
+
+    template<typename T>
+    void test_max_index(std::mt19937& rng, T max)
+    {
+        // sizes cover empty input, scalar tail and several simd iterations
+        for (size_t size = 0; size < 80; ++size)
+        {
+            const auto indices = random_indices<T>(rng, size, max);
+            const GLuint expected = size ? *std::max_element(indices.begin(), indices.end()) : 0;
+            GLCXX_CHECK(expected == glcxx::max_index(indices.data(), size));
+        }
+
+        // max value in every position, including the last one
+        std::vector<T> indices(37, 1);
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            indices[i] = max;
+            GLCXX_CHECK(max == glcxx::max_index(indices.data(), indices.size()));
+            indices[i] = 1;
+        }
+    }
+
+    template<typename From, typename To>
+    void test_convert(std::mt19937& rng)
+    {
+        for (size_t size = 0; size < 80; ++size)
+        {
+            const auto src = random_indices<From>(rng, size, std::numeric_limits<To>::max());
+            std::vector<To> dst(size);
+            glcxx::convert_indices(src.data(), size, dst.data());
+            GLCXX_CHECK(std::equal(src.begin(), src.end(), dst.begin()));
+        }
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    test_max_index<GLuint>(rng, 0xffffffff);
+    test_max_index<GLuint>(rng, 0xffff);
+    test_max_index<GLushort>(rng, 0xffff);
+    test_max_index<GLushort>(rng, 0x7fff);
+    test_max_index<GLubyte>(rng, 0xff);
+    test_convert<GLuint, GLushort>(rng);
+    test_convert<GLuint, GLubyte>(rng);
+    test_convert<GLushort, GLubyte>(rng);
+    return glcxx_test::result();
+}
@@ -0,0 +1,190 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/mesh_optimizer.hpp"
+#include "check.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// @brief triangles of index vector rotated so that smallest index goes
+    /// first, winding is kept, sorted
+    template<typename T>
+    std::vector<std::array<GLuint, 3>> triangles(const std::vector<T>& indices)
+    {
+        std::vector<std::array<GLuint, 3>> retval;
+        for (size_t i = 0; i + 3 <= indices.size(); i += 3)
+        {
+            std::array<GLuint, 3> t{{indices[i], indices[i + 1], indices[i + 2]}};
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            retval.push_back(t);
+        }
+        std::sort(retval.begin(), retval.end());
+        return retval;
+    }
+
+    /// @brief uv sphere with given number of segments, returns positions,
+    /// indices are appended to indices
+    template<typename T>
+    std::vector<glm::vec3> sphere(size_t rings, size_t segments, std::vector<T>& indices)
+    {
+        std::vector<glm::vec3> positions;
+        for (size_t r = 0; r <= rings; ++r)
+        {
+            const float theta = 3.14159265f*r/rings;
+            for (size_t s = 0; s <= segments; ++s)
+            {
+                const float phi = 2.f*3.14159265f*s/segments;
+                positions.emplace_back(std::sin(theta)*std::cos(phi), std::cos(theta), std::sin(theta)*std::sin(phi));
+            }
+        }
+        for (size_t r = 0; r < rings; ++r)
+        {
+            for (size_t s = 0; s < segments; ++s)
+            {
+                const T a = T(r*(segments + 1) + s), b = T(a + segments + 1);
+                indices.insert(indices.end(), {a, b, T(a + 1), T(a + 1), b, T(b + 1)});
+            }
+        }
+        return positions;
+    }
+
+    /// @brief shuffles triangles, keeping their winding
+    template<typename T>
+    void shuffle_triangles(std::vector<T>& indices, std::mt19937& rng)
+    {
+        std::vector<size_t> order(indices.size()/3);
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), rng);
+        std::vector<T> result;
+        for (auto t : order)
+            result.insert(result.end(), indices.begin() + 3*t, indices.begin() + 3*t + 3);
+        indices.swap(result);
+    }
+
+    void test_analyze()
+    {
+        const std::vector<GLuint> single{0, 1, 2};
+        auto stats = glcxx::analyze_vertex_cache(single, 3);
+        GLCXX_CHECK(3 == stats.vertices_transformed);
+        GLCXX_CHECK(3.f == stats.acmr);
+        GLCXX_CHECK(1.f == stats.atvr);
+
+        // second triangle reuses cached edge
+        const std::vector<GLuint> quad{0, 1, 2, 2, 1, 3};
+        stats = glcxx::analyze_vertex_cache(quad, 4);
+        GLCXX_CHECK(4 == stats.vertices_transformed);
+        GLCXX_CHECK(2.f == stats.acmr);
+        GLCXX_CHECK(1.f == stats.atvr);
+
+        // vertex evicted from 3 entry cache is transformed again
+        const std::vector<GLuint> evict{0, 1, 2, 3, 4, 5, 0, 1, 2};
+        stats = glcxx::analyze_vertex_cache(evict, 6, 3);
+        GLCXX_CHECK(9 == stats.vertices_transformed);
+        GLCXX_CHECK(1.5f == stats.atvr);
+    }
+
+    template<typename T>
+    void test_vertex_cache(std::mt19937& rng)
+    {
+        std::vector<T> indices;
+        const auto positions = sphere(32, 32, indices);
+        shuffle_triangles(indices, rng);
+        const auto before = glcxx::analyze_vertex_cache(indices, positions.size());
+        const auto original = triangles(indices);
+
+        glcxx::optimize_vertex_cache(indices, positions.size());
+        const auto after = glcxx::analyze_vertex_cache(indices, positions.size());
+
+        // same triangles with same winding, only order differs
+        GLCXX_CHECK(original == triangles(indices));
+        GLCXX_CHECK(before.acmr > 2.f);
+        GLCXX_CHECK(after.acmr < 0.8f);
+        GLCXX_CHECK(after.acmr < before.acmr/2.f);
+    }
+
+    template<typename T>
+    void test_overdraw(std::mt19937& rng)
+    {
+        std::vector<T> indices;
+        const auto positions = sphere(32, 32, indices);
+        shuffle_triangles(indices, rng);
+        glcxx::optimize_vertex_cache(indices, positions.size());
+        const auto before = glcxx::analyze_vertex_cache(indices, positions.size());
+        const auto original = triangles(indices);
+
+        const float threshold = 1.05f;
+        glcxx::optimize_overdraw(indices, positions, threshold);
+        const auto after = glcxx::analyze_vertex_cache(indices, positions.size());
+
+        GLCXX_CHECK(original == triangles(indices));
+        // clusters are cut when cluster drawn with cold cache is nearly as
+        // efficient as whole mesh, so reordering keeps acmr within threshold
+        GLCXX_CHECK(after.acmr <= before.acmr*threshold + 0.01f);
+    }
+
+    template<typename T>
+    void test_vertex_fetch(std::mt19937& rng)
+    {
+        std::vector<T> indices;
+        const auto positions = sphere(8, 8, indices);
+        shuffle_triangles(indices, rng);
+        // unused vertex is dropped
+        const size_t vertex_num = positions.size() + 1;
+        auto remapped = indices;
+        const auto remap = glcxx::optimize_vertex_fetch(remapped, vertex_num);
+        const auto new_positions = glcxx::remap_vertices(positions, remap);
+
+        GLCXX_CHECK(~0u == remap.back());
+        GLCXX_CHECK(positions.size() == new_positions.size());
+        // every index still refers to same vertex
+        bool same = true;
+        for (size_t i = 0; i < indices.size(); ++i)
+            same = same && positions[indices[i]] == new_positions[remapped[i]];
+        GLCXX_CHECK(same);
+        // vertices are numbered in order of first use
+        GLuint next = 0;
+        bool ordered = true;
+        for (auto i : remapped)
+        {
+            ordered = ordered && i <= next;
+            if (i == next)
+                ++next;
+        }
+        GLCXX_CHECK(ordered);
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    test_analyze();
+    test_vertex_cache<GLuint>(rng);
+    test_vertex_cache<GLushort>(rng);
+    test_overdraw<GLuint>(rng);
+    test_overdraw<GLushort>(rng);
+    test_vertex_fetch<GLuint>(rng);
+    test_vertex_fetch<GLubyte>(rng);
+    return glcxx_test::result();
+}
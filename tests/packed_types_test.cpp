@@ -0,0 +1,155 @@
+// Copyright 2016 Grygorii Fuchedzhy <gfuchedzhy@gmail.com>
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "glcxx/packed_types.hpp"
+#include "check.hpp"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+    /// @brief random floats slightly outside of [-1,1] to exercise clamping
+    std::vector<float> random_floats(std::mt19937& rng, size_t size)
+    {
+        std::uniform_real_distribution<float> dist(-1.25f, 1.25f);
+        std::vector<float> retval(size);
+        for (auto& f : retval)
+            f = dist(rng);
+        return retval;
+    }
+
+    void test_half()
+    {
+        // every finite half survives round trip through float
+        for (GLuint h = 0; h <= 0xffff; ++h)
+        {
+            if ((h & 0x7c00) == 0x7c00)
+                continue;
+            GLCXX_CHECK(h == glcxx::float_to_half(glcxx::half_to_float(GLushort(h))));
+        }
+
+        GLCXX_CHECK(0x3c00 == glcxx::float_to_half(1.f));
+        GLCXX_CHECK(0xc000 == glcxx::float_to_half(-2.f));
+        GLCXX_CHECK(0x7bff == glcxx::float_to_half(65504.f));
+        GLCXX_CHECK(0x7c00 == glcxx::float_to_half(1e6f));
+        GLCXX_CHECK(0xfc00 == glcxx::float_to_half(-std::numeric_limits<float>::infinity()));
+        GLCXX_CHECK(0x0001 == glcxx::float_to_half(std::ldexp(1.f, -24)));
+        GLCXX_CHECK(0x7c00 == (glcxx::float_to_half(std::numeric_limits<float>::quiet_NaN()) & 0x7c00));
+        GLCXX_CHECK(0 != (glcxx::float_to_half(std::numeric_limits<float>::quiet_NaN()) & 0x3ff));
+
+        // halfway between 1 and next half rounds to even
+        GLCXX_CHECK(0x3c00 == glcxx::float_to_half(1.f + std::ldexp(1.f, -11)));
+        GLCXX_CHECK(0x3c02 == glcxx::float_to_half(1.f + 3*std::ldexp(1.f, -11)));
+    }
+
+    void test_pack_half(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> dist(-70000.f, 70000.f);
+        for (size_t size = 0; size < 40; ++size)
+        {
+            std::vector<float> src(size);
+            for (auto& f : src)
+                f = dist(rng);
+            std::vector<GLushort> dst(size);
+            glcxx::pack_half(src.data(), size, dst.data());
+            for (size_t i = 0; i < size; ++i)
+                GLCXX_CHECK(glcxx::float_to_half(src[i]) == dst[i]);
+        }
+
+        const glcxx::half3 h = {{0x3c00, 0xc000, 0x3800}};
+        const glm::vec2 v = static_cast<glm::vec2>(h);
+        GLCXX_CHECK(1.f == v.x && -2.f == v.y);
+    }
+
+    /// @brief checks that simd and scalar tail of pack_normalized produce
+    /// the same values as straightforward reference conversion
+    template<typename T>
+    void test_normalized(std::mt19937& rng)
+    {
+        constexpr float max = float(std::numeric_limits<T>::max());
+        constexpr float lo = std::numeric_limits<T>::is_signed ? -1.f : 0.f;
+        for (size_t size = 0; size < 40; ++size)
+        {
+            const auto src = random_floats(rng, size);
+            std::vector<T> dst(size);
+            glcxx::pack_normalized(src.data(), size, dst.data());
+            for (size_t i = 0; i < size; ++i)
+            {
+                const T expected = T(std::nearbyint(std::min(std::max(src[i], lo), 1.f)*max));
+                GLCXX_CHECK(expected == dst[i]);
+            }
+        }
+
+        // extremes decode to exactly -1, 0 and 1
+        glcxx::normalized_vec<T, 2> v = {{std::numeric_limits<T>::min(), std::numeric_limits<T>::max()}};
+        const glm::vec2 f = static_cast<glm::vec2>(v);
+        GLCXX_CHECK(lo == f.x && 1.f == f.y);
+    }
+
+    void test_int_2_10_10_10_rev(std::mt19937& rng)
+    {
+        for (size_t size = 0; size < 20; ++size)
+        {
+            const auto src = random_floats(rng, size*4);
+            std::vector<glm::vec4> vec4s(size);
+            std::vector<glm::vec3> vec3s(size);
+            for (size_t i = 0; i < size; ++i)
+            {
+                vec4s[i] = glm::vec4(src[4*i], src[4*i + 1], src[4*i + 2], src[4*i + 3]);
+                vec3s[i] = glm::vec3(src[4*i], src[4*i + 1], src[4*i + 2]);
+            }
+            std::vector<glcxx::int_2_10_10_10_rev> packed4(size), packed3(size);
+            glcxx::pack_int_2_10_10_10_rev(vec4s.data(), size, packed4.data());
+            glcxx::pack_int_2_10_10_10_rev(vec3s.data(), size, packed3.data());
+            for (size_t i = 0; i < size; ++i)
+            {
+                const glm::vec4 v = static_cast<glm::vec4>(packed4[i]);
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float clamped = std::min(std::max(vec4s[i][c], -1.f), 1.f);
+                    GLCXX_CHECK(std::abs(v[c] - clamped) <= 0.5f/511.f + 1e-6f);
+                }
+                GLCXX_CHECK(std::nearbyint(std::min(std::max(vec4s[i].w, -1.f), 1.f)) == v.w);
+
+                // vec3 packing only differs in zero w
+                GLCXX_CHECK((packed4[i].bits & 0x3fffffff) == packed3[i].bits);
+            }
+        }
+
+        // x is stored in lowest bits, components are sign extended
+        const glcxx::int_2_10_10_10_rev r = {0x1ffu | 0x201u << 10 | 0u << 20 | 1u << 30};
+        const glm::vec4 v = static_cast<glm::vec4>(r);
+        GLCXX_CHECK(1.f == v.x && -1.f == v.y && 0.f == v.z && 1.f == v.w);
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    test_half();
+    test_pack_half(rng);
+    test_normalized<GLbyte>(rng);
+    test_normalized<GLubyte>(rng);
+    test_normalized<GLshort>(rng);
+    test_normalized<GLushort>(rng);
+    test_int_2_10_10_10_rev(rng);
+    return glcxx_test::result();
+}